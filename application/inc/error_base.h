@@ -20,6 +20,8 @@
 #include "td1208.h"
 #include "trcs.h"
 // Middleware.
+#include "event.h"
+#include "timer.h"
 #include "analog.h"
 #include "hmi.h"
 #include "serial.h"
@@ -44,7 +46,9 @@ typedef enum {
     ERROR_BASE_TD1208 = (ERROR_BASE_TERMINAL_SERIAL + TERMINAL_ERROR_BASE_LAST),
     ERROR_BASE_TRCS = (ERROR_BASE_TD1208 + TD1208_ERROR_BASE_LAST),
     // Middleware.
-    ERROR_BASE_ANALOG = (ERROR_BASE_TRCS + TRCS_ERROR_BASE_LAST),
+    ERROR_BASE_EVENT = (ERROR_BASE_TRCS + TRCS_ERROR_BASE_LAST),
+    ERROR_BASE_TIMER = (ERROR_BASE_EVENT + EVENT_ERROR_BASE_LAST),
+    ERROR_BASE_ANALOG = (ERROR_BASE_TIMER + TIMER_ERROR_BASE_LAST),
     ERROR_BASE_HMI = (ERROR_BASE_ANALOG + ANALOG_ERROR_BASE_LAST),
     ERROR_BASE_SERIAL = (ERROR_BASE_HMI + HMI_ERROR_BASE_LAST),
     ERROR_BASE_SIGFOX = (ERROR_BASE_SERIAL + SERIAL_ERROR_BASE_LAST),
@@ -16,11 +16,14 @@
 #include "rtc.h"
 // Utils.
 #include "error.h"
+#include "types.h"
 // Middleware
 #include "analog.h"
+#include "event.h"
 #include "hmi.h"
 #include "serial.h"
 #include "sigfox.h"
+#include "timer.h"
 // Applicative.
 #include "error_base.h"
 #include "psfe_flags.h"
@@ -30,14 +33,105 @@
 #define PSFE_MCU_VOLTAGE_THRESHOLD_ON_MV    3300
 #define PSFE_MCU_VOLTAGE_THRESHOLD_OFF_MV   3100
 
+/*** MAIN local structures ***/
+
+/*******************************************************************/
+typedef struct {
+    uint8_t board_state;
+} PSFE_context_t;
+
+/*** MAIN local global variables ***/
+
+static PSFE_context_t psfe_ctx = {
+    .board_state = 0
+};
+
 /*** MAIN local functions ***/
 
+/*******************************************************************/
+static void _PSFE_mcu_voltage_data_ready_callback(ANALOG_channel_t channel, int64_t sum, uint32_t number_of_samples) {
+    // Unused parameters.
+    UNUSED(channel);
+    UNUSED(sum);
+    UNUSED(number_of_samples);
+    // Defer power supply check to main loop.
+    EVENT_post(EVENT_POWER_SUPPLY_CHECK);
+}
+
+/*******************************************************************/
+static void _PSFE_power_supply_check_event_handler(void) {
+    // Local variables.
+    ANALOG_status_t analog_status = ANALOG_SUCCESS;
+    HMI_status_t hmi_status = HMI_SUCCESS;
+#ifdef PSFE_SERIAL_MONITORING
+    SERIAL_status_t serial_status = SERIAL_SUCCESS;
+#endif
+#ifdef PSFE_SIGFOX_MONITORING
+    SIGFOX_status_t sigfox_status = SIGFOX_SUCCESS;
+#endif
+    int32_t mcu_voltage_mv = 0;
+    // Check board power supply.
+    analog_status = ANALOG_read_channel(ANALOG_CHANNEL_MCU_VOLTAGE_MV, &mcu_voltage_mv);
+    ANALOG_stack_error(ERROR_BASE_ANALOG);
+    // Manage modules state.
+    if ((mcu_voltage_mv < PSFE_MCU_VOLTAGE_THRESHOLD_OFF_MV) && (psfe_ctx.board_state != 0)) {
+        // Stop TRCS board.
+        analog_status = ANALOG_stop_trcs();
+        ANALOG_stack_error(ERROR_BASE_ANALOG);
+        // Stop front-end.
+        hmi_status = HMI_stop();
+        HMI_stack_error(ERROR_BASE_HMI);
+#ifdef PSFE_SERIAL_MONITORING
+        serial_status = SERIAL_stop();
+        SERIAL_stack_error(ERROR_BASE_SERIAL);
+#endif
+#ifdef PSFE_SIGFOX_MONITORING
+        sigfox_status = SIGFOX_stop();
+        SIGFOX_stack_error(ERROR_BASE_SIGFOX);
+#endif
+        // Update state.
+        psfe_ctx.board_state = 0;
+    }
+    if ((mcu_voltage_mv > PSFE_MCU_VOLTAGE_THRESHOLD_ON_MV) && (psfe_ctx.board_state == 0)) {
+        // Start TRCS board.
+        analog_status = ANALOG_start_trcs();
+        ANALOG_stack_error(ERROR_BASE_ANALOG);
+        // Start front-end.
+        hmi_status = HMI_start();
+        HMI_stack_error(ERROR_BASE_HMI);
+#ifdef PSFE_SERIAL_MONITORING
+        serial_status = SERIAL_start();
+        SERIAL_stack_error(ERROR_BASE_SERIAL);
+#endif
+#ifdef PSFE_SIGFOX_MONITORING
+        sigfox_status = SIGFOX_start();
+        SIGFOX_stack_error(ERROR_BASE_SIGFOX);
+#endif
+        // Update state.
+        psfe_ctx.board_state = 1;
+    }
+}
+
+/*******************************************************************/
+static void _PSFE_sleep(void) {
+    // Mask interrupts so that an event posted after the check still wakes up the core.
+    __asm volatile ("cpsid i" : : : "memory");
+    // Enter sleep mode if there is no pending event.
+    if (EVENT_is_pending() == 0) {
+        PWR_enter_sleep_mode(PWR_SLEEP_MODE_NORMAL);
+    }
+    // Serve pending interrupts.
+    __asm volatile ("cpsie i" : : : "memory");
+}
+
 /*******************************************************************/
 static void _PSFE_init_hw(void) {
     // Local variables.
     RCC_status_t rcc_status = RCC_SUCCESS;
     RTC_status_t rtc_status = RTC_SUCCESS;
     LPTIM_status_t lptim_status = LPTIM_SUCCESS;
+    EVENT_status_t event_status = EVENT_SUCCESS;
+    TIMER_status_t timer_status = TIMER_SUCCESS;
     ANALOG_status_t analog_status = ANALOG_SUCCESS;
     HMI_status_t hmi_status = HMI_SUCCESS;
 #ifndef PSFE_MODE_DEBUG
@@ -76,6 +170,9 @@ static void _PSFE_init_hw(void) {
     lptim_status = LPTIM_init(NVIC_PRIORITY_DELAY);
     LPTIM_stack_error(ERROR_BASE_LPTIM);
     // Init middleware modules.
+    EVENT_init();
+    timer_status = TIMER_init();
+    TIMER_stack_error(ERROR_BASE_TIMER);
     analog_status = ANALOG_init();
     ANALOG_stack_error(ERROR_BASE_ANALOG);
     hmi_status = HMI_init();
@@ -88,6 +185,11 @@ static void _PSFE_init_hw(void) {
     sigfox_status = SIGFOX_init();
     SIGFOX_stack_error(ERROR_BASE_SIGFOX);
 #endif
+    // Check power supply on each MCU voltage conversion.
+    event_status = EVENT_register(EVENT_POWER_SUPPLY_CHECK, &_PSFE_power_supply_check_event_handler);
+    EVENT_stack_error(ERROR_BASE_EVENT);
+    analog_status = ANALOG_subscribe(ANALOG_CHANNEL_MCU_VOLTAGE_MV, 1, &_PSFE_mcu_voltage_data_ready_callback);
+    ANALOG_stack_error(ERROR_BASE_ANALOG);
 }
 
 /*** MAIN function ***/
@@ -95,73 +197,26 @@ static void _PSFE_init_hw(void) {
 /*******************************************************************/
 int main(void) {
     // Local variables.
-    ANALOG_status_t analog_status = ANALOG_SUCCESS;
-    HMI_status_t hmi_status = HMI_SUCCESS;
-#ifdef PSFE_SERIAL_MONITORING
-    SERIAL_status_t serial_status = SERIAL_SUCCESS;
-#endif
+    EVENT_status_t event_status = EVENT_SUCCESS;
 #ifdef PSFE_SIGFOX_MONITORING
     SIGFOX_status_t sigfox_status = SIGFOX_SUCCESS;
 #endif
-    uint8_t board_state = 0;
-    int32_t mcu_voltage_mv = 0;
     // Init board.
     _PSFE_init_hw();
     // Main loop.
     while (1) {
         // Reload watchdog.
         IWDG_reload();
-        // Process modules.
-        analog_status = ANALOG_process();
-        ANALOG_stack_error(ERROR_BASE_ANALOG);
-#ifdef PSFE_SERIAL_MONITORING
-        serial_status = SERIAL_process();
-        SERIAL_stack_error(ERROR_BASE_SERIAL);
-#endif
+        // Dispatch events posted under interrupt.
+        event_status = EVENT_process();
+        EVENT_stack_error(ERROR_BASE_EVENT);
 #ifdef PSFE_SIGFOX_MONITORING
+        // Process modules.
         sigfox_status = SIGFOX_process();
         SIGFOX_stack_error(ERROR_BASE_SIGFOX);
 #endif
-        // Check board power supply.
-        analog_status = ANALOG_read_channel(ANALOG_CHANNEL_MCU_VOLTAGE_MV, &mcu_voltage_mv);
-        ANALOG_stack_error(ERROR_BASE_ANALOG);
-        // Manage modules state.
-        if ((mcu_voltage_mv < PSFE_MCU_VOLTAGE_THRESHOLD_OFF_MV) && (board_state != 0)) {
-            // Stop TRCS board.
-            analog_status = ANALOG_stop_trcs();
-            ANALOG_stack_error(ERROR_BASE_ANALOG);
-            // Stop front-end.
-            hmi_status = HMI_stop();
-            HMI_stack_error(ERROR_BASE_HMI);
-#ifdef PSFE_SERIAL_MONITORING
-            serial_status = SERIAL_stop();
-            SERIAL_stack_error(ERROR_BASE_SERIAL);
-#endif
-#ifdef PSFE_SIGFOX_MONITORING
-            sigfox_status = SIGFOX_stop();
-            SIGFOX_stack_error(ERROR_BASE_SIGFOX);
-#endif
-            // Update state.
-            board_state = 0;
-        }
-        if ((mcu_voltage_mv > PSFE_MCU_VOLTAGE_THRESHOLD_ON_MV) && (board_state == 0)) {
-            // Stop TRCS board.
-            analog_status = ANALOG_start_trcs();
-            ANALOG_stack_error(ERROR_BASE_ANALOG);
-            // Start front-end.
-            hmi_status = HMI_start();
-            HMI_stack_error(ERROR_BASE_HMI);
-#ifdef PSFE_SERIAL_MONITORING
-            serial_status = SERIAL_start();
-            SERIAL_stack_error(ERROR_BASE_SERIAL);
-#endif
-#ifdef PSFE_SIGFOX_MONITORING
-            sigfox_status = SIGFOX_start();
-            SIGFOX_stack_error(ERROR_BASE_SIGFOX);
-#endif
-            // Update state.
-            board_state = 1;
-        }
+        // Wait for next interrupt.
+        _PSFE_sleep();
     }
     return 0;
 }
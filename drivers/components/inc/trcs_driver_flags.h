@@ -9,12 +9,12 @@
 #define __TRCS_DRIVER_FLAGS_H__
 
 #include "adc.h"
-#include "tim.h"
+#include "timer.h"
 
 /*** TRCS driver compilation flags ***/
 
 #define TRCS_DRIVER_GPIO_ERROR_BASE_LAST    0
-#define TRCS_DRIVER_TIMER_ERROR_BASE_LAST   TIM_ERROR_BASE_LAST
+#define TRCS_DRIVER_TIMER_ERROR_BASE_LAST   TIMER_ERROR_BASE_LAST
 #define TRCS_DRIVER_ADC_ERROR_BASE_LAST     ADC_ERROR_BASE_LAST
 
 #define TRCS_DRIVER_ADC_RANGE_MV            3300
@@ -14,22 +14,77 @@
 #include "error.h"
 #include "error_base.h"
 #include "gpio.h"
+#include "gpio_registers.h"
 #include "mcu_mapping.h"
 #include "nvic_priority.h"
 #include "tim.h"
+#include "timer.h"
 #include "trcs.h"
 #include "types.h"
 
 #ifndef TRCS_DRIVER_DISABLE
 
+/*** TRCS HW local macros ***/
+
+#define TRCS_HW_NUMBER_OF_PORTS     2
+// Both ranges are closed during this delay when switching, so that the output current path is never open.
+#define TRCS_HW_RANGE_OVERLAP_US    50
+
 /*** TRCS HW local global variables ***/
 
+static TIMER_t trcs_hw_timer;
+static uint8_t trcs_hw_output_current_range_update = 0;
+static GPIO_registers_t* trcs_hw_port[TRCS_HW_NUMBER_OF_PORTS];
+static uint8_t trcs_hw_range_port_index[TRCS_OUTPUT_CURRENT_RANGE_LAST];
+static volatile uint32_t trcs_hw_break_mask[TRCS_HW_NUMBER_OF_PORTS];
+
 static const GPIO_pin_t* const TRCS_HW_GPIO_RANGE[TRCS_OUTPUT_CURRENT_RANGE_LAST] = {
     &GPIO_TRCS_OUTPUT_CURRENT_RANGE_LOW,
     &GPIO_TRCS_OUTPUT_CURRENT_RANGE_MIDDLE,
     &GPIO_TRCS_OUTPUT_CURRENT_RANGE_HIGH
 };
 
+/*** TRCS HW local functions ***/
+
+/*******************************************************************/
+static uint32_t _TRCS_HW_enter_critical(void) {
+    // Local variables.
+    uint32_t primask = 0;
+    // Save interrupt state and mask interrupts.
+    __asm volatile ("mrs %0, primask" : "=r" (primask));
+    __asm volatile ("cpsid i" : : : "memory");
+    return primask;
+}
+
+/*******************************************************************/
+static void _TRCS_HW_exit_critical(uint32_t primask) {
+    // Restore interrupt state.
+    __asm volatile ("msr primask, %0" : : "r" (primask) : "memory");
+}
+
+/*******************************************************************/
+static void _TRCS_HW_apply_breaks(void) {
+    // Local variables.
+    uint8_t idx = 0;
+    // Open all pending ranges with a single write per port.
+    for (idx = 0; idx < TRCS_HW_NUMBER_OF_PORTS; idx++) {
+        if (trcs_hw_break_mask[idx] != 0) {
+            (trcs_hw_port[idx]->BSRR) = (trcs_hw_break_mask[idx] << 16);
+            trcs_hw_break_mask[idx] = 0;
+        }
+    }
+}
+
+/*******************************************************************/
+static void _TRCS_HW_overlap_irq_callback(void) {
+    // Local variables.
+    TIM_status_t tim_status = TIM_SUCCESS;
+    // Overlap elapsed.
+    _TRCS_HW_apply_breaks();
+    tim_status = TIM_STD_stop(TIM_INSTANCE_TRCS);
+    TIM_stack_error(ERROR_BASE_TRCS + TRCS_ERROR_BASE_TIMER + TIMER_ERROR_BASE_TIM);
+}
+
 /*** TRCS HW functions ***/
 
 /*******************************************************************/
@@ -37,14 +92,32 @@ TRCS_status_t TRCS_HW_init(void) {
     // Local variables.
     TRCS_status_t status = TRCS_SUCCESS;
     TIM_status_t tim_status = TIM_SUCCESS;
+    GPIO_registers_t* port = NULL;
     uint8_t idx = 0;
+    uint8_t port_idx = 0;
+    // Reset ports table.
+    for (port_idx = 0; port_idx < TRCS_HW_NUMBER_OF_PORTS; port_idx++) {
+        trcs_hw_port[port_idx] = NULL;
+        trcs_hw_break_mask[port_idx] = 0;
+    }
     // Init GPIOs.
     for (idx = 0; idx < TRCS_OUTPUT_CURRENT_RANGE_LAST; idx++) {
         GPIO_configure(TRCS_HW_GPIO_RANGE[idx], GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_HIGH, GPIO_PULL_NONE);
+        // Group range pins by port.
+        port = (GPIO_registers_t*) (TRCS_HW_GPIO_RANGE[idx]->port);
+        for (port_idx = 0; port_idx < TRCS_HW_NUMBER_OF_PORTS; port_idx++) {
+            if ((trcs_hw_port[port_idx] == NULL) || (trcs_hw_port[port_idx] == port)) break;
+        }
+        if (port_idx >= TRCS_HW_NUMBER_OF_PORTS) {
+            status = TRCS_ERROR_RANGE;
+            goto errors;
+        }
+        trcs_hw_port[port_idx] = port;
+        trcs_hw_range_port_index[idx] = port_idx;
     }
-    // Init sampling timer.
-    tim_status = TIM_STD_init(TIM_INSTANCE_TRCS, NVIC_PRIORITY_TRCS_TIMER);
-    TIM_exit_error(TRCS_ERROR_BASE_TIMER);
+    // Init overlap timer.
+    tim_status = TIM_STD_init(TIM_INSTANCE_TRCS, NVIC_PRIORITY_TRCS);
+    TIM_exit_error(TRCS_ERROR_BASE_TIMER + TIMER_ERROR_BASE_TIM);
 errors:
     return status;
 }
@@ -53,10 +126,17 @@ errors:
 TRCS_status_t TRCS_HW_de_init(void) {
     // Local variables.
     TRCS_status_t status = TRCS_SUCCESS;
+    TIMER_status_t timer_status = TIMER_SUCCESS;
     TIM_status_t tim_status = TIM_SUCCESS;
-    // Release sampling timer.
+    // Release overlap timer.
+    tim_status = TIM_STD_stop(TIM_INSTANCE_TRCS);
+    TIM_stack_error(ERROR_BASE_TRCS + TRCS_ERROR_BASE_TIMER + TIMER_ERROR_BASE_TIM);
+    _TRCS_HW_apply_breaks();
     tim_status = TIM_STD_de_init(TIM_INSTANCE_TRCS);
-    TIM_stack_error(ERROR_BASE_TRCS + TRCS_ERROR_BASE_TIMER);
+    TIM_stack_error(ERROR_BASE_TRCS + TRCS_ERROR_BASE_TIMER + TIMER_ERROR_BASE_TIM);
+    // Release sampling timer.
+    timer_status = TIMER_stop(&trcs_hw_timer);
+    TIMER_stack_error(ERROR_BASE_TRCS + TRCS_ERROR_BASE_TIMER);
     return status;
 }
 
@@ -64,10 +144,10 @@ TRCS_status_t TRCS_HW_de_init(void) {
 TRCS_status_t TRCS_HW_timer_start(uint32_t period_ms, TRCS_HW_timer_irq_cb_t irq_callback) {
     // Local variables.
     TRCS_status_t status = TRCS_SUCCESS;
-    TIM_status_t tim_status = TIM_SUCCESS;
+    TIMER_status_t timer_status = TIMER_SUCCESS;
     // Start sampling timer.
-    tim_status = TIM_STD_start(TIM_INSTANCE_TRCS, period_ms, TIM_UNIT_MS, irq_callback);
-    TIM_exit_error(TRCS_ERROR_BASE_TIMER);
+    timer_status = TIMER_start(&trcs_hw_timer, period_ms, TIMER_MODE_PERIODIC, TIMER_DISPATCH_IRQ, irq_callback);
+    TIMER_exit_error(TRCS_ERROR_BASE_TIMER);
 errors:
     return status;
 }
@@ -76,10 +156,10 @@ errors:
 TRCS_status_t TRCS_HW_timer_stop(void) {
     // Local variables.
     TRCS_status_t status = TRCS_SUCCESS;
-    TIM_status_t tim_status = TIM_SUCCESS;
+    TIMER_status_t timer_status = TIMER_SUCCESS;
     // Stop sampling timer.
-    tim_status = TIM_STD_stop(TIM_INSTANCE_TRCS);
-    TIM_exit_error(TRCS_ERROR_BASE_TIMER);
+    timer_status = TIMER_stop(&trcs_hw_timer);
+    TIMER_exit_error(TRCS_ERROR_BASE_TIMER);
 errors:
     return status;
 }
@@ -88,13 +168,36 @@ errors:
 TRCS_status_t TRCS_HW_set_output_current_range_state(TRCS_output_current_range_t output_current_range, uint8_t state){
     // Local variables.
     TRCS_status_t status = TRCS_SUCCESS;
+    TIM_status_t tim_status = TIM_SUCCESS;
+    GPIO_registers_t* port = NULL;
+    uint32_t pin_mask = 0;
+    uint32_t primask = 0;
+    uint8_t port_idx = 0;
     // Check parameter.
     if (output_current_range >= TRCS_OUTPUT_CURRENT_RANGE_LAST) {
         status = TRCS_ERROR_RANGE;
         goto errors;
     }
-    // Set GPIO.
-    GPIO_write(TRCS_HW_GPIO_RANGE[output_current_range], state);
+    port_idx = trcs_hw_range_port_index[output_current_range];
+    port = trcs_hw_port[port_idx];
+    pin_mask = (0b1 << (TRCS_HW_GPIO_RANGE[output_current_range]->pin));
+    if (state != 0) {
+        // Make: close range immediately and cancel its pending break (the overlap interrupt also writes the mask).
+        primask = _TRCS_HW_enter_critical();
+        trcs_hw_break_mask[port_idx] &= ~pin_mask;
+        (port->BSRR) = pin_mask;
+        _TRCS_HW_exit_critical(primask);
+    }
+    else {
+        // Break: open range once the overlap has elapsed, so that the next range is closed first whatever the calls order.
+        tim_status = TIM_STD_stop(TIM_INSTANCE_TRCS);
+        TIM_exit_error(TRCS_ERROR_BASE_TIMER + TIMER_ERROR_BASE_TIM);
+        trcs_hw_break_mask[port_idx] |= pin_mask;
+        tim_status = TIM_STD_start(TIM_INSTANCE_TRCS, TRCS_HW_RANGE_OVERLAP_US, TIM_UNIT_US, &_TRCS_HW_overlap_irq_callback);
+        TIM_exit_error(TRCS_ERROR_BASE_TIMER + TIMER_ERROR_BASE_TIM);
+    }
+    // Samples taken before the switch must not be used.
+    trcs_hw_output_current_range_update = 1;
 errors:
     return status;
 }
@@ -104,8 +207,15 @@ TRCS_status_t TRCS_HW_adc_get_output_current(int32_t* output_current_mv) {
     // Local variables.
     TRCS_status_t status = TRCS_SUCCESS;
     ANALOG_status_t analog_status = ANALOG_SUCCESS;
-    // Read data.
-    analog_status = ANALOG_read_channel(ANALOG_CHANNEL_OUTPUT_CURRENT_MV, output_current_mv);
+    // Convert on demand after a range switch (called after settling time), otherwise read the last completed 1ms output current window.
+    // Both are called from TRCS_process(), which only runs in the main loop.
+    if (trcs_hw_output_current_range_update != 0) {
+        trcs_hw_output_current_range_update = 0;
+        analog_status = ANALOG_convert_output_current(output_current_mv);
+    }
+    else {
+        analog_status = ANALOG_read_channel(ANALOG_CHANNEL_OUTPUT_CURRENT_MV, output_current_mv);
+    }
     ANALOG_exit_error(TRCS_ERROR_BASE_ADC);
 errors:
     return status;
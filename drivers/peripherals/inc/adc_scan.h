@@ -0,0 +1,158 @@
+/*
+ * adc_scan.h
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef __ADC_SCAN_H__
+#define __ADC_SCAN_H__
+
+#include "error.h"
+#include "gpio.h"
+#include "rcc.h"
+#include "types.h"
+
+/*** ADC SCAN structures ***/
+
+/*!******************************************************************
+ * \enum ADC_SCAN_status_t
+ * \brief ADC scan driver error codes.
+ *******************************************************************/
+typedef enum {
+    // Driver errors.
+    ADC_SCAN_SUCCESS = 0,
+    ADC_SCAN_ERROR_NULL_PARAMETER,
+    ADC_SCAN_ERROR_CHANNEL_MASK,
+    ADC_SCAN_ERROR_SAMPLING_TIME,
+    ADC_SCAN_ERROR_NUMBER_OF_SCANS,
+    ADC_SCAN_ERROR_PERIOD,
+    ADC_SCAN_ERROR_STATE,
+    ADC_SCAN_ERROR_CALIBRATION_TIMEOUT,
+    ADC_SCAN_ERROR_READY_TIMEOUT,
+    ADC_SCAN_ERROR_STOP_TIMEOUT,
+    ADC_SCAN_ERROR_WATCHDOG_CHANNEL,
+    ADC_SCAN_ERROR_WATCHDOG_THRESHOLD,
+    // Low level drivers errors.
+    ADC_SCAN_ERROR_BASE_RCC = ERROR_BASE_STEP,
+    // Last base value.
+    ADC_SCAN_ERROR_BASE_LAST = (ADC_SCAN_ERROR_BASE_RCC + RCC_ERROR_BASE_LAST)
+} ADC_SCAN_status_t;
+
+/*!******************************************************************
+ * \enum ADC_SCAN_sampling_time_t
+ * \brief ADC sampling time list (common to all channels of the scan).
+ *******************************************************************/
+typedef enum {
+    ADC_SCAN_SAMPLING_TIME_1_5_CYCLES = 0,
+    ADC_SCAN_SAMPLING_TIME_3_5_CYCLES,
+    ADC_SCAN_SAMPLING_TIME_7_5_CYCLES,
+    ADC_SCAN_SAMPLING_TIME_12_5_CYCLES,
+    ADC_SCAN_SAMPLING_TIME_19_5_CYCLES,
+    ADC_SCAN_SAMPLING_TIME_39_5_CYCLES,
+    ADC_SCAN_SAMPLING_TIME_79_5_CYCLES,
+    ADC_SCAN_SAMPLING_TIME_160_5_CYCLES,
+    ADC_SCAN_SAMPLING_TIME_LAST
+} ADC_SCAN_sampling_time_t;
+
+/*!******************************************************************
+ * \fn ADC_SCAN_block_cplt_irq_cb_t
+ * \brief ADC scan block completion callback.
+ * \param[in]   block: Pointer to the first sample of the completed block.
+ * \param[in]   number_of_scans: Number of scans in the block.
+ *******************************************************************/
+typedef void (*ADC_SCAN_block_cplt_irq_cb_t)(uint16_t* block, uint16_t number_of_scans);
+
+/*!******************************************************************
+ * \fn ADC_SCAN_watchdog_irq_cb_t
+ * \brief ADC analog watchdog callback (the watchdog is disarmed until next configuration).
+ * \param[in]   data: Last sample of the guarded channel.
+ *******************************************************************/
+typedef void (*ADC_SCAN_watchdog_irq_cb_t)(uint16_t data);
+
+/*!******************************************************************
+ * \struct ADC_SCAN_configuration_t
+ * \brief ADC scan configuration structure.
+ *******************************************************************/
+typedef struct {
+    const GPIO_pin_t** gpio_list;
+    uint8_t gpio_list_size;
+    uint32_t channel_mask;
+    ADC_SCAN_sampling_time_t sampling_time;
+    uint16_t* buffer;
+    uint16_t number_of_scans_per_block;
+    ADC_SCAN_block_cplt_irq_cb_t block_cplt_irq_callback;
+    uint8_t nvic_priority;
+    ADC_SCAN_watchdog_irq_cb_t watchdog_irq_callback;
+    uint8_t watchdog_nvic_priority;
+} ADC_SCAN_configuration_t;
+
+/*** ADC SCAN functions ***/
+
+/*!******************************************************************
+ * \fn ADC_SCAN_status_t ADC_SCAN_init(ADC_SCAN_configuration_t* configuration)
+ * \brief Init hardware triggered ADC scan with DMA transfer.
+ * \brief The driver owns ADC1, DMA1 channel 1 and TIM22 (including their interrupt handlers), so it must not be used with the generic ADC driver.
+ * \param[in]   configuration: Pointer to the scan configuration. The buffer must contain (2 * number_of_scans_per_block * number_of_channels) samples.
+ * \param[out]  none
+ * \retval      Function execution status.
+ *******************************************************************/
+ADC_SCAN_status_t ADC_SCAN_init(ADC_SCAN_configuration_t* configuration);
+
+/*!******************************************************************
+ * \fn ADC_SCAN_status_t ADC_SCAN_de_init(void)
+ * \brief Release hardware triggered ADC scan.
+ * \param[in]   none
+ * \param[out]  none
+ * \retval      Function execution status.
+ *******************************************************************/
+ADC_SCAN_status_t ADC_SCAN_de_init(void);
+
+/*!******************************************************************
+ * \fn ADC_SCAN_status_t ADC_SCAN_start(uint32_t period_us)
+ * \brief Start periodic ADC scan.
+ * \param[in]   period_us: Trigger period in microseconds.
+ * \param[out]  none
+ * \retval      Function execution status.
+ *******************************************************************/
+ADC_SCAN_status_t ADC_SCAN_start(uint32_t period_us);
+
+/*!******************************************************************
+ * \fn ADC_SCAN_status_t ADC_SCAN_stop(void)
+ * \brief Stop periodic ADC scan.
+ * \param[in]   none
+ * \param[out]  none
+ * \retval      Function execution status.
+ *******************************************************************/
+ADC_SCAN_status_t ADC_SCAN_stop(void);
+
+/*!******************************************************************
+ * \fn ADC_SCAN_status_t ADC_SCAN_set_watchdog(uint8_t channel, uint16_t low_threshold, uint16_t high_threshold)
+ * \brief Arm the analog watchdog on a scanned channel (applied between two scans).
+ * \param[in]   channel: ADC channel to guard.
+ * \param[in]   low_threshold: Watchdog triggers when a sample is below this value.
+ * \param[in]   high_threshold: Watchdog triggers when a sample is above this value.
+ * \param[out]  none
+ * \retval      Function execution status.
+ *******************************************************************/
+ADC_SCAN_status_t ADC_SCAN_set_watchdog(uint8_t channel, uint16_t low_threshold, uint16_t high_threshold);
+
+/*!******************************************************************
+ * \fn ADC_SCAN_status_t ADC_SCAN_disable_watchdog(void)
+ * \brief Disable the analog watchdog (applied between two scans).
+ * \param[in]   none
+ * \param[out]  none
+ * \retval      Function execution status.
+ *******************************************************************/
+ADC_SCAN_status_t ADC_SCAN_disable_watchdog(void);
+
+/*******************************************************************/
+#define ADC_SCAN_exit_error(base) { ERROR_check_exit(adc_scan_status, ADC_SCAN_SUCCESS, base) }
+
+/*******************************************************************/
+#define ADC_SCAN_stack_error(base) { ERROR_check_stack(adc_scan_status, ADC_SCAN_SUCCESS, base) }
+
+/*******************************************************************/
+#define ADC_SCAN_stack_exit_error(base, code) { ERROR_check_stack_exit(adc_scan_status, ADC_SCAN_SUCCESS, base, code) }
+
+#endif /* __ADC_SCAN_H__ */
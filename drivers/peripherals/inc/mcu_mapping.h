@@ -20,9 +20,9 @@
 #define ADC_CHANNEL_OUTPUT_VOLTAGE  ADC_CHANNEL_IN8
 #define ADC_CHANNEL_OUTPUT_CURRENT  ADC_CHANNEL_IN0
 
-#define TIM_INSTANCE_HMI            TIM_INSTANCE_TIM2
-#define TIM_INSTANCE_ANALOG         TIM_INSTANCE_TIM21
-#define TIM_INSTANCE_TRCS           TIM_INSTANCE_TIM22
+#define TIM_INSTANCE_TIMER          TIM_INSTANCE_TIM2
+#define TIM_INSTANCE_TRCS           TIM_INSTANCE_TIM21
+// TIM22 is reserved for the ADC scan trigger.
 
 #define USART_INSTANCE_TD1208       USART_INSTANCE_USART2
 
@@ -20,11 +20,13 @@ typedef enum {
     NVIC_PRIORITY_RTC = 3,
     // TD1208.
     NVIC_PRIORITY_TD1208_UART = 0,
+    // Timer service.
+    NVIC_PRIORITY_TIMER = 1,
+    // TRCS range sequencer.
+    NVIC_PRIORITY_TRCS = 0,
     // Analog measurements
-    NVIC_PRIORITY_TRCS_TIMER = 1,
-    NVIC_PRIORITY_ANALOG_TIMER = 2,
-    // HMI.
-    NVIC_PRIORITY_HMI_TIMER = 3,
+    NVIC_PRIORITY_ANALOG_WATCHDOG = 1,
+    NVIC_PRIORITY_ANALOG_DMA = 2,
     // Log interface
     NVIC_PRIORITY_SERIAL = 3,
 } NVIC_priority_list_t;
@@ -10,6 +10,7 @@
 
 /*** STM32L0xx drivers compilation flags ***/
 
+// DMA1 channel 1 (and its interrupt handler) is owned by the ADC scan driver.
 #define STM32L0XX_DRIVERS_DMA_CHANNEL_MASK              0x00
 
 #define STM32L0XX_DRIVERS_EXTI_GPIO_MASK                0x0000
@@ -0,0 +1,493 @@
+/*
+ * adc_scan.c
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "adc_scan.h"
+
+#include "adc_registers.h"
+#include "dma_registers.h"
+#include "error.h"
+#include "gpio.h"
+#include "nvic.h"
+#include "rcc.h"
+#include "rcc_registers.h"
+#include "syscfg_registers.h"
+#include "tim_registers.h"
+#include "types.h"
+
+/*** ADC SCAN local macros ***/
+
+// TIM22 update event is routed to the ADC through TRGO (EXTSEL=TRG4).
+#define ADC_SCAN_TIMER                      TIM22
+#define ADC_SCAN_TIMER_EXTSEL               0b100
+
+#define ADC_SCAN_NUMBER_OF_CHANNELS_MAX     19
+#define ADC_SCAN_TIMER_ARR_MAX              0x00010000
+
+#define ADC_SCAN_TIMEOUT_COUNT              1000000
+
+// Watchdog update window: the ADC clock is assumed to be at least a quarter of the system clock,
+// and the stop, reconfiguration and restart sequence to take less than 512 system clock cycles.
+#define ADC_SCAN_ADC_CLOCK_DIVIDER_MAX      4
+#define ADC_SCAN_WATCHDOG_UPDATE_CYCLES     512
+
+// Watchdog request packed in a single word so that it can be written atomically.
+#define ADC_SCAN_WATCHDOG_ENABLE            (0b1 << 31)
+#define ADC_SCAN_WATCHDOG_CHANNEL_SHIFT     24
+#define ADC_SCAN_WATCHDOG_HIGH_SHIFT        12
+#define ADC_SCAN_WATCHDOG_THRESHOLD_MASK    0x0FFF
+#define ADC_SCAN_WATCHDOG_CHANNEL_MASK      0x1F
+
+/*** ADC SCAN local structures ***/
+
+/*******************************************************************/
+typedef struct {
+    uint8_t init_flag;
+    uint8_t running_flag;
+    uint32_t channel_mask;
+    ADC_SCAN_sampling_time_t sampling_time;
+    uint16_t* buffer;
+    uint8_t number_of_channels;
+    uint16_t block_size;
+    uint16_t number_of_scans_per_block;
+    ADC_SCAN_block_cplt_irq_cb_t block_cplt_irq_callback;
+    uint8_t nvic_priority;
+    ADC_SCAN_watchdog_irq_cb_t watchdog_irq_callback;
+    uint8_t watchdog_nvic_priority;
+    volatile uint32_t watchdog_request;
+    volatile uint32_t watchdog_applied;
+    uint32_t watchdog_window_start_ticks;
+    uint32_t watchdog_window_end_ticks;
+} ADC_SCAN_context_t;
+
+/*** ADC SCAN local global variables ***/
+
+static ADC_SCAN_context_t adc_scan_ctx = {
+    .init_flag = 0,
+    .running_flag = 0,
+    .channel_mask = 0,
+    .sampling_time = ADC_SCAN_SAMPLING_TIME_160_5_CYCLES,
+    .buffer = NULL,
+    .number_of_channels = 0,
+    .block_size = 0,
+    .number_of_scans_per_block = 0,
+    .block_cplt_irq_callback = NULL,
+    .nvic_priority = 0,
+    .watchdog_irq_callback = NULL,
+    .watchdog_nvic_priority = 0,
+    .watchdog_request = 0,
+    .watchdog_applied = 0,
+    .watchdog_window_start_ticks = 0,
+    .watchdog_window_end_ticks = 0
+};
+
+// Conversion time of one channel in half ADC clock cycles (sampling time + 12.5 cycles).
+static const uint16_t ADC_SCAN_CONVERSION_HALF_CYCLES[ADC_SCAN_SAMPLING_TIME_LAST] = { 28, 32, 40, 50, 64, 104, 184, 346 };
+
+/*** ADC SCAN local functions ***/
+
+/*******************************************************************/
+static uint32_t _ADC_SCAN_enter_critical(void) {
+    // Local variables.
+    uint32_t primask = 0;
+    // Save interrupt state and mask interrupts.
+    __asm volatile ("mrs %0, primask" : "=r" (primask));
+    __asm volatile ("cpsid i" : : : "memory");
+    return primask;
+}
+
+/*******************************************************************/
+static void _ADC_SCAN_exit_critical(uint32_t primask) {
+    // Restore interrupt state.
+    __asm volatile ("msr primask, %0" : : "r" (primask) : "memory");
+}
+
+/*******************************************************************/
+static void _ADC_SCAN_apply_watchdog(uint32_t request) {
+    // Disable watchdog (ADC must be stopped).
+    ADC1->IER &= ~(0b1 << 7);
+    ADC1->CFGR1 &= ~((0b11111 << 26) | (0b1 << 23) | (0b1 << 22));
+    ADC1->ISR = (0b1 << 7);
+    // Configure single channel watchdog.
+    if ((request & ADC_SCAN_WATCHDOG_ENABLE) != 0) {
+        ADC1->TR = (((request >> ADC_SCAN_WATCHDOG_HIGH_SHIFT) & ADC_SCAN_WATCHDOG_THRESHOLD_MASK) << 16) | (request & ADC_SCAN_WATCHDOG_THRESHOLD_MASK);
+        ADC1->CFGR1 |= (((request >> ADC_SCAN_WATCHDOG_CHANNEL_SHIFT) & ADC_SCAN_WATCHDOG_CHANNEL_MASK) << 26) | (0b1 << 23) | (0b1 << 22);
+        ADC1->IER |= (0b1 << 7);
+    }
+    adc_scan_ctx.watchdog_applied = request;
+}
+
+/*******************************************************************/
+static void _ADC_SCAN_update_watchdog(void) {
+    // Local variables.
+    uint32_t request = adc_scan_ctx.watchdog_request;
+    uint32_t counter = 0;
+    uint32_t primask = 0;
+    uint32_t loop_count = 0;
+    // Check if configuration changed.
+    if (request == adc_scan_ctx.watchdog_applied) goto errors;
+    // Mask interrupts so that the window check remains valid until the ADC is re-armed.
+    primask = _ADC_SCAN_enter_critical();
+    counter = (ADC_SCAN_TIMER->CNT);
+    // Watchdog registers can only be written when the ADC is stopped, which is only done between two scans (otherwise retried on next block):
+    // - All transferred samples must belong to complete scans.
+    // - A scan triggered less than one conversion ago may not have transferred any sample yet.
+    // - Next trigger must not occur before the ADC is re-armed.
+    if ((((DMA1->CNDTR1) % adc_scan_ctx.number_of_channels) == 0) && (counter >= adc_scan_ctx.watchdog_window_start_ticks) && (counter <= adc_scan_ctx.watchdog_window_end_ticks)) {
+        // Stop ADC (no conversion ongoing).
+        ADC1->CR |= (0b1 << 4);
+        while (((ADC1->CR) & (0b1 << 2)) != 0) {
+            // Exit if timeout.
+            loop_count++;
+            if (loop_count > ADC_SCAN_TIMEOUT_COUNT) break;
+        }
+        _ADC_SCAN_apply_watchdog(request);
+        // Re-arm ADC on external trigger.
+        ADC1->CR |= (0b1 << 2);
+    }
+    _ADC_SCAN_exit_critical(primask);
+errors:
+    return;
+}
+
+/*******************************************************************/
+static uint16_t _ADC_SCAN_get_last_data(uint8_t channel) {
+    // Local variables.
+    uint32_t buffer_size = (uint32_t) (adc_scan_ctx.block_size << 1);
+    uint32_t index = 0;
+    uint8_t rank = 0;
+    uint8_t idx = 0;
+    // Get rank of the channel in the scan.
+    for (idx = 0; idx < channel; idx++) {
+        if (((adc_scan_ctx.channel_mask) & (0b1 << idx)) != 0) {
+            rank++;
+        }
+    }
+    // Index of the last sample transferred by the DMA.
+    index = ((buffer_size - (DMA1->CNDTR1) + buffer_size - 1) % buffer_size);
+    // Go back to the channel sample of the same or previous scan.
+    index = ((index + buffer_size - (((index % adc_scan_ctx.number_of_channels) + adc_scan_ctx.number_of_channels - rank) % adc_scan_ctx.number_of_channels)) % buffer_size);
+    return adc_scan_ctx.buffer[index];
+}
+
+/*******************************************************************/
+void ADC1_COMP_IRQHandler(void) {
+    // Local variables.
+    uint16_t data = 0;
+    // Analog watchdog.
+    if ((((ADC1->ISR) & (0b1 << 7)) != 0) && (((ADC1->IER) & (0b1 << 7)) != 0)) {
+        // Disarm watchdog until next configuration.
+        ADC1->IER &= ~(0b1 << 7);
+        ADC1->ISR = (0b1 << 7);
+        adc_scan_ctx.watchdog_applied = 0;
+        // Call callback.
+        if (adc_scan_ctx.watchdog_irq_callback != NULL) {
+            data = _ADC_SCAN_get_last_data((uint8_t) (((ADC1->CFGR1) >> 26) & ADC_SCAN_WATCHDOG_CHANNEL_MASK));
+            adc_scan_ctx.watchdog_irq_callback(data);
+        }
+    }
+}
+
+/*******************************************************************/
+void DMA1_Channel1_IRQHandler(void) {
+    // Update watchdog between two scans.
+    _ADC_SCAN_update_watchdog();
+    // Half transfer: first block is complete.
+    if (((DMA1->ISR) & (0b1 << 2)) != 0) {
+        // Clear flag.
+        DMA1->IFCR = (0b1 << 2);
+        // Call callback.
+        if (adc_scan_ctx.block_cplt_irq_callback != NULL) {
+            adc_scan_ctx.block_cplt_irq_callback(&(adc_scan_ctx.buffer[0]), adc_scan_ctx.number_of_scans_per_block);
+        }
+    }
+    // Transfer complete: second block is complete.
+    if (((DMA1->ISR) & (0b1 << 1)) != 0) {
+        // Clear flag.
+        DMA1->IFCR = (0b1 << 1);
+        // Call callback.
+        if (adc_scan_ctx.block_cplt_irq_callback != NULL) {
+            adc_scan_ctx.block_cplt_irq_callback(&(adc_scan_ctx.buffer[adc_scan_ctx.block_size]), adc_scan_ctx.number_of_scans_per_block);
+        }
+    }
+    // Transfer error.
+    if (((DMA1->ISR) & (0b1 << 3)) != 0) {
+        // Clear flag.
+        DMA1->IFCR = (0b1 << 3);
+    }
+}
+
+/*** ADC SCAN functions ***/
+
+/*******************************************************************/
+ADC_SCAN_status_t ADC_SCAN_init(ADC_SCAN_configuration_t* configuration) {
+    // Local variables.
+    ADC_SCAN_status_t status = ADC_SCAN_SUCCESS;
+    uint32_t loop_count = 0;
+    uint8_t number_of_channels = 0;
+    uint8_t idx = 0;
+    // Check parameters.
+    if (configuration == NULL) {
+        status = ADC_SCAN_ERROR_NULL_PARAMETER;
+        goto errors;
+    }
+    if (((configuration->buffer) == NULL) || ((configuration->block_cplt_irq_callback) == NULL) || (((configuration->gpio_list) == NULL) && ((configuration->gpio_list_size) != 0))) {
+        status = ADC_SCAN_ERROR_NULL_PARAMETER;
+        goto errors;
+    }
+    if ((configuration->number_of_scans_per_block) == 0) {
+        status = ADC_SCAN_ERROR_NUMBER_OF_SCANS;
+        goto errors;
+    }
+    if ((configuration->sampling_time) >= ADC_SCAN_SAMPLING_TIME_LAST) {
+        status = ADC_SCAN_ERROR_SAMPLING_TIME;
+        goto errors;
+    }
+    // Count channels.
+    for (idx = 0; idx < ADC_SCAN_NUMBER_OF_CHANNELS_MAX; idx++) {
+        if (((configuration->channel_mask) & (0b1 << idx)) != 0) {
+            number_of_channels++;
+        }
+    }
+    if ((number_of_channels == 0) || (((configuration->channel_mask) >> ADC_SCAN_NUMBER_OF_CHANNELS_MAX) != 0)) {
+        status = ADC_SCAN_ERROR_CHANNEL_MASK;
+        goto errors;
+    }
+    // Init context.
+    adc_scan_ctx.channel_mask = (configuration->channel_mask);
+    adc_scan_ctx.sampling_time = (configuration->sampling_time);
+    adc_scan_ctx.buffer = (configuration->buffer);
+    adc_scan_ctx.number_of_channels = number_of_channels;
+    adc_scan_ctx.number_of_scans_per_block = (configuration->number_of_scans_per_block);
+    adc_scan_ctx.block_size = (uint16_t) ((configuration->number_of_scans_per_block) * number_of_channels);
+    adc_scan_ctx.block_cplt_irq_callback = (configuration->block_cplt_irq_callback);
+    adc_scan_ctx.nvic_priority = (configuration->nvic_priority);
+    adc_scan_ctx.watchdog_irq_callback = (configuration->watchdog_irq_callback);
+    adc_scan_ctx.watchdog_nvic_priority = (configuration->watchdog_nvic_priority);
+    adc_scan_ctx.watchdog_request = 0;
+    adc_scan_ctx.watchdog_applied = 0;
+    adc_scan_ctx.running_flag = 0;
+    // Init analog inputs.
+    for (idx = 0; idx < (configuration->gpio_list_size); idx++) {
+        GPIO_configure((configuration->gpio_list)[idx], GPIO_MODE_ANALOG, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
+    }
+    // Enable peripherals clock: DMA, ADC registers (ADCEN) and SYSCFG (SYSCFGEN, required for the CFGR3 buffers below).
+    RCC->AHBENR |= (0b1 << 0);
+    RCC->APB2ENR |= (0b1 << 9) | (0b1 << 0);
+    // Enable internal reference and temperature sensor buffers.
+    SYSCFG->CFGR3 |= (0b11 << 8) | (0b1 << 0);
+    // ADC clock is PCLK/2 (synchronous with the trigger timer, within the watchdog update window assumption).
+    ADC1->CFGR2 = (0b01 << 30);
+    // Enable voltage regulator and calibrate ADC (must be disabled).
+    ADC1->CR |= (0b1 << 28);
+    ADC1->ISR = (0b1 << 11);
+    ADC1->CR |= (0b1 << 31);
+    while (((ADC1->ISR) & (0b1 << 11)) == 0) {
+        // Exit if timeout.
+        loop_count++;
+        if (loop_count > ADC_SCAN_TIMEOUT_COUNT) {
+            status = ADC_SCAN_ERROR_CALIBRATION_TIMEOUT;
+            goto errors;
+        }
+    }
+    ADC1->ISR = (0b1 << 11);
+    // Update flag.
+    adc_scan_ctx.init_flag = 1;
+errors:
+    return status;
+}
+
+/*******************************************************************/
+ADC_SCAN_status_t ADC_SCAN_de_init(void) {
+    // Local variables.
+    ADC_SCAN_status_t status = ADC_SCAN_SUCCESS;
+    uint32_t loop_count = 0;
+    // Stop scan if needed.
+    if (adc_scan_ctx.running_flag != 0) {
+        status = ADC_SCAN_stop();
+    }
+    // Disable ADC and its voltage regulator.
+    if (((ADC1->CR) & (0b1 << 0)) != 0) {
+        ADC1->CR |= (0b1 << 1);
+        while (((ADC1->CR) & (0b1 << 0)) != 0) {
+            // Exit if timeout.
+            loop_count++;
+            if (loop_count > ADC_SCAN_TIMEOUT_COUNT) break;
+        }
+    }
+    ADC1->CR &= ~(0b1 << 28);
+    // Disable internal reference and temperature sensor buffers.
+    SYSCFG->CFGR3 &= ~(0b11 << 8);
+    // Release ADC registers clock.
+    RCC->APB2ENR &= ~(0b1 << 9);
+    // Update flag.
+    adc_scan_ctx.init_flag = 0;
+    return status;
+}
+
+/*******************************************************************/
+ADC_SCAN_status_t ADC_SCAN_start(uint32_t period_us) {
+    // Local variables.
+    ADC_SCAN_status_t status = ADC_SCAN_SUCCESS;
+    RCC_status_t rcc_status = RCC_SUCCESS;
+    uint32_t clock_hz = 0;
+    uint64_t period_ticks = 0;
+    uint32_t psc = 0;
+    uint32_t loop_count = 0;
+    // Check state.
+    if ((adc_scan_ctx.init_flag == 0) || (adc_scan_ctx.running_flag != 0)) {
+        status = ADC_SCAN_ERROR_STATE;
+        goto errors;
+    }
+    // Compute timer settings.
+    rcc_status = RCC_get_frequency_hz(RCC_CLOCK_SYSTEM, &clock_hz);
+    RCC_exit_error(ADC_SCAN_ERROR_BASE_RCC);
+    period_ticks = (((uint64_t) clock_hz) * ((uint64_t) period_us)) / ((uint64_t) 1000000);
+    psc = (uint32_t) (period_ticks / ((uint64_t) ADC_SCAN_TIMER_ARR_MAX));
+    if ((period_ticks == 0) || (psc >= ADC_SCAN_TIMER_ARR_MAX)) {
+        status = ADC_SCAN_ERROR_PERIOD;
+        goto errors;
+    }
+    // Watchdog update window in timer ticks.
+    adc_scan_ctx.watchdog_window_start_ticks = (((uint32_t) ADC_SCAN_CONVERSION_HALF_CYCLES[adc_scan_ctx.sampling_time] * ADC_SCAN_ADC_CLOCK_DIVIDER_MAX) / (2 * (psc + 1))) + 1;
+    adc_scan_ctx.watchdog_window_end_ticks = (uint32_t) ((period_ticks / ((uint64_t) (psc + 1))) - 1);
+    if (adc_scan_ctx.watchdog_window_end_ticks > ((ADC_SCAN_WATCHDOG_UPDATE_CYCLES / (psc + 1)) + 1)) {
+        adc_scan_ctx.watchdog_window_end_ticks -= ((ADC_SCAN_WATCHDOG_UPDATE_CYCLES / (psc + 1)) + 1);
+    }
+    // Configure trigger timer.
+    RCC->APB2ENR |= (0b1 << 5);
+    ADC_SCAN_TIMER->CR1 = 0;
+    ADC_SCAN_TIMER->PSC = psc;
+    ADC_SCAN_TIMER->ARR = (uint32_t) ((period_ticks / ((uint64_t) (psc + 1))) - 1);
+    // Update event on TRGO.
+    ADC_SCAN_TIMER->CR2 = (0b010 << 4);
+    ADC_SCAN_TIMER->EGR = (0b1 << 0);
+    ADC_SCAN_TIMER->SR = 0;
+    // Configure DMA channel 1 (ADC request): 16-bits transfers, memory increment, circular mode, half and full transfer interrupts.
+    DMA1->CCR1 &= ~(0b1 << 0);
+    DMA1->IFCR = (0b1111 << 0);
+    DMA1->CSELR &= ~(0b1111 << 0);
+    DMA1->CPAR1 = (uint32_t) &(ADC1->DR);
+    DMA1->CMAR1 = (uint32_t) adc_scan_ctx.buffer;
+    DMA1->CNDTR1 = (uint32_t) (adc_scan_ctx.block_size << 1);
+    DMA1->CCR1 = (0b10 << 12) | (0b01 << 10) | (0b01 << 8) | (0b1 << 7) | (0b1 << 5) | (0b1 << 2) | (0b1 << 1);
+    DMA1->CCR1 |= (0b1 << 0);
+    NVIC_enable_interrupt(NVIC_INTERRUPT_DMA1_CH_1, adc_scan_ctx.nvic_priority);
+    // Configure ADC: 12-bits right aligned, rising edge external trigger, DMA circular mode.
+    ADC1->CFGR1 &= ~((0b1 << 16) | (0b1 << 15) | (0b1 << 13) | (0b11 << 10) | (0b111 << 6) | (0b1 << 5) | (0b11 << 3) | (0b1 << 2));
+    ADC1->CFGR1 |= (0b01 << 10) | (ADC_SCAN_TIMER_EXTSEL << 6) | (0b1 << 1) | (0b1 << 0);
+    // Select scan channels (converted by ascending channel number) and sampling time.
+    ADC1->CHSELR = adc_scan_ctx.channel_mask;
+    ADC1->SMPR = (uint32_t) adc_scan_ctx.sampling_time;
+    // Enable internal channels.
+    ADC1->CCR |= (0b11 << 22);
+    // Analog watchdog interrupt.
+    if (adc_scan_ctx.watchdog_irq_callback != NULL) {
+        NVIC_enable_interrupt(NVIC_INTERRUPT_ADC_COMP, adc_scan_ctx.watchdog_nvic_priority);
+    }
+    // Enable ADC if needed.
+    if (((ADC1->CR) & (0b1 << 0)) == 0) {
+        ADC1->ISR = (0b1 << 0);
+        ADC1->CR |= (0b1 << 0);
+        while (((ADC1->ISR) & (0b1 << 0)) == 0) {
+            // Exit if timeout.
+            loop_count++;
+            if (loop_count > ADC_SCAN_TIMEOUT_COUNT) {
+                status = ADC_SCAN_ERROR_READY_TIMEOUT;
+                goto errors;
+            }
+        }
+    }
+    // Apply watchdog configuration and arm ADC on external trigger.
+    _ADC_SCAN_apply_watchdog(adc_scan_ctx.watchdog_request);
+    ADC1->CR |= (0b1 << 2);
+    // Start trigger timer.
+    ADC_SCAN_TIMER->CR1 |= (0b1 << 0);
+    // Update flag.
+    adc_scan_ctx.running_flag = 1;
+    return status;
+errors:
+    // Release hardware (except if the scan was already running).
+    if (adc_scan_ctx.running_flag == 0) {
+        ADC_SCAN_TIMER->CR1 &= ~(0b1 << 0);
+        DMA1->CCR1 &= ~(0b1 << 0);
+        NVIC_disable_interrupt(NVIC_INTERRUPT_DMA1_CH_1);
+        NVIC_disable_interrupt(NVIC_INTERRUPT_ADC_COMP);
+        ADC1->CFGR1 &= ~((0b11 << 10) | (0b1 << 1) | (0b1 << 0));
+        ADC1->CCR &= ~(0b11 << 22);
+        RCC->APB2ENR &= ~(0b1 << 5);
+    }
+    return status;
+}
+
+/*******************************************************************/
+ADC_SCAN_status_t ADC_SCAN_stop(void) {
+    // Local variables.
+    ADC_SCAN_status_t status = ADC_SCAN_SUCCESS;
+    uint32_t loop_count = 0;
+    // Stop trigger timer.
+    ADC_SCAN_TIMER->CR1 &= ~(0b1 << 0);
+    // Stop ongoing conversions.
+    if (((ADC1->CR) & (0b1 << 2)) != 0) {
+        ADC1->CR |= (0b1 << 4);
+        while (((ADC1->CR) & (0b1 << 2)) != 0) {
+            // Exit if timeout.
+            loop_count++;
+            if (loop_count > ADC_SCAN_TIMEOUT_COUNT) {
+                status = ADC_SCAN_ERROR_STOP_TIMEOUT;
+                break;
+            }
+        }
+    }
+    // Release ADC trigger and DMA.
+    ADC1->CFGR1 &= ~((0b11 << 10) | (0b1 << 1) | (0b1 << 0));
+    ADC1->CCR &= ~(0b11 << 22);
+    DMA1->CCR1 &= ~(0b1 << 0);
+    DMA1->IFCR = (0b1111 << 0);
+    NVIC_disable_interrupt(NVIC_INTERRUPT_DMA1_CH_1);
+    // Release analog watchdog.
+    ADC1->IER &= ~(0b1 << 7);
+    ADC1->CFGR1 &= ~((0b11111 << 26) | (0b1 << 23) | (0b1 << 22));
+    ADC1->ISR = (0b1 << 7);
+    NVIC_disable_interrupt(NVIC_INTERRUPT_ADC_COMP);
+    // Release trigger timer.
+    RCC->APB2ENR &= ~(0b1 << 5);
+    // Update flag.
+    adc_scan_ctx.running_flag = 0;
+    return status;
+}
+
+/*******************************************************************/
+ADC_SCAN_status_t ADC_SCAN_set_watchdog(uint8_t channel, uint16_t low_threshold, uint16_t high_threshold) {
+    // Local variables.
+    ADC_SCAN_status_t status = ADC_SCAN_SUCCESS;
+    // Check parameters.
+    if ((adc_scan_ctx.init_flag == 0) || (adc_scan_ctx.watchdog_irq_callback == NULL)) {
+        status = ADC_SCAN_ERROR_STATE;
+        goto errors;
+    }
+    if ((channel >= ADC_SCAN_NUMBER_OF_CHANNELS_MAX) || (((adc_scan_ctx.channel_mask) & (0b1 << channel)) == 0)) {
+        status = ADC_SCAN_ERROR_WATCHDOG_CHANNEL;
+        goto errors;
+    }
+    if ((low_threshold > ADC_SCAN_WATCHDOG_THRESHOLD_MASK) || (high_threshold > ADC_SCAN_WATCHDOG_THRESHOLD_MASK) || (low_threshold > high_threshold)) {
+        status = ADC_SCAN_ERROR_WATCHDOG_THRESHOLD;
+        goto errors;
+    }
+    // Request configuration (applied by the DMA interrupt).
+    adc_scan_ctx.watchdog_request = ADC_SCAN_WATCHDOG_ENABLE | (((uint32_t) channel) << ADC_SCAN_WATCHDOG_CHANNEL_SHIFT) | (((uint32_t) high_threshold) << ADC_SCAN_WATCHDOG_HIGH_SHIFT) | ((uint32_t) low_threshold);
+errors:
+    return status;
+}
+
+/*******************************************************************/
+ADC_SCAN_status_t ADC_SCAN_disable_watchdog(void) {
+    // Local variables.
+    ADC_SCAN_status_t status = ADC_SCAN_SUCCESS;
+    // Request configuration (applied by the DMA interrupt).
+    adc_scan_ctx.watchdog_request = 0;
+    return status;
+}
@@ -9,12 +9,22 @@
 #define __ANALOG_H__
 
 #include "adc.h"
+#include "adc_scan.h"
 #include "error.h"
+#include "event.h"
 #include "nvm.h"
-#include "tim.h"
+#include "timer.h"
 #include "trcs.h"
 #include "types.h"
 
+/*** ANALOG macros ***/
+
+#define ANALOG_ERROR_VALUE                  0x7FFFFFFF
+
+#define ANALOG_SPECTRUM_NUMBER_OF_BINS      4
+
+#define ANALOG_JOURNAL_DEPTH                16
+
 /*** ANALOG structures ***/
 
 /*!******************************************************************
@@ -28,13 +38,35 @@ typedef enum {
     ANALOG_ERROR_BOARD_NUMBER,
     ANALOG_ERROR_CHANNEL,
     ANALOG_ERROR_CALIBRATION_MISSING,
+    ANALOG_ERROR_TEMPERATURE_CALIBRATION,
+    ANALOG_ERROR_CAPTURE_TRIGGER,
+    ANALOG_ERROR_CAPTURE_PRE_TRIGGER_SAMPLES,
+    ANALOG_ERROR_CAPTURE_STATE,
+    ANALOG_ERROR_CAPTURE_INDEX,
+    ANALOG_ERROR_DECIMATION,
+    ANALOG_ERROR_SUBSCRIPTION_FULL,
+    ANALOG_ERROR_SUBSCRIPTION_NOT_FOUND,
+    ANALOG_ERROR_ALARM,
+    ANALOG_ERROR_ALARM_THRESHOLD,
+    ANALOG_ERROR_STATISTICS_FULL,
+    ANALOG_ERROR_STATISTICS_ID,
+    ANALOG_ERROR_QUANTILE,
+    ANALOG_ERROR_QUANTILE_NO_SAMPLE,
+    ANALOG_ERROR_FILTER_MEDIAN_TAPS,
+    ANALOG_ERROR_SPECTRUM_BIN,
+    ANALOG_ERROR_SPECTRUM_FREQUENCY,
+    ANALOG_ERROR_OUTPUT_CURRENT_TIMEOUT,
+    ANALOG_ERROR_JOURNAL_SEQUENCE,
+    ANALOG_ERROR_CONTEXT,
     // Low level drivers errors.
     ANALOG_ERROR_BASE_ADC = ERROR_BASE_STEP,
     ANALOG_ERROR_BASE_NVM = (ANALOG_ERROR_BASE_ADC + ADC_ERROR_BASE_LAST),
-    ANALOG_ERROR_BASE_TIM = (ANALOG_ERROR_BASE_NVM + NVM_ERROR_BASE_LAST),
-    ANALOG_ERROR_BASE_TRCS = (ANALOG_ERROR_BASE_TIM + TIM_ERROR_BASE_LAST),
+    ANALOG_ERROR_BASE_ADC_SCAN = (ANALOG_ERROR_BASE_NVM + NVM_ERROR_BASE_LAST),
+    ANALOG_ERROR_BASE_TRCS = (ANALOG_ERROR_BASE_ADC_SCAN + ADC_SCAN_ERROR_BASE_LAST),
+    ANALOG_ERROR_BASE_EVENT = (ANALOG_ERROR_BASE_TRCS + TRCS_ERROR_BASE_LAST),
+    ANALOG_ERROR_BASE_TIMER = (ANALOG_ERROR_BASE_EVENT + EVENT_ERROR_BASE_LAST),
     // Last base value.
-    ANALOG_ERROR_BASE_LAST = (ANALOG_ERROR_BASE_TRCS + TRCS_ERROR_BASE_LAST)
+    ANALOG_ERROR_BASE_LAST = (ANALOG_ERROR_BASE_TIMER + TIMER_ERROR_BASE_LAST)
 } ANALOG_status_t;
 
 /*!******************************************************************
@@ -47,6 +79,9 @@ typedef enum {
     ANALOG_CHANNEL_OUTPUT_VOLTAGE_MV,
     ANALOG_CHANNEL_OUTPUT_CURRENT_MV,
     ANALOG_CHANNEL_OUTPUT_CURRENT_UA,
+    ANALOG_CHANNEL_OUTPUT_POWER_UW,
+    ANALOG_CHANNEL_OUTPUT_RIPPLE_PEAK_TO_PEAK_MV,
+    ANALOG_CHANNEL_OUTPUT_RIPPLE_RMS_MV,
     ANALOG_CHANNEL_LAST
 } ANALOG_channel_t;
 
@@ -63,6 +98,152 @@ typedef enum {
     ANALOG_OUTPUT_CURRENT_RANGE_LAST
 } ANALOG_output_current_range_t;
 
+/*!******************************************************************
+ * \struct ANALOG_snapshot_t
+ * \brief Coherent set of analog data.
+ *******************************************************************/
+typedef struct {
+    uint32_t sequence;
+    uint64_t timestamp_us;
+    int32_t data[ANALOG_CHANNEL_LAST];
+    int32_t filtered_data[ANALOG_CHANNEL_LAST];
+    ANALOG_output_current_range_t output_current_range;
+    uint8_t bypass_switch_state;
+    uint8_t output_current_valid;
+} ANALOG_snapshot_t;
+
+/*!******************************************************************
+ * \struct ANALOG_filter_configuration_t
+ * \brief Channel filter parameters (median is applied first, then first order low pass).
+ *******************************************************************/
+typedef struct {
+    uint8_t median_taps;
+    uint32_t time_constant_ms;
+    int32_t step_threshold;
+} ANALOG_filter_configuration_t;
+
+/*!******************************************************************
+ * \fn ANALOG_data_ready_cb_t
+ * \brief New data notification callback (called under interrupt, the average sum / number_of_samples has to be computed in main context).
+ * \param[in]   channel: Channel which has been updated.
+ * \param[in]   sum: Sum of the channel valid conversions since the previous notification.
+ * \param[in]   number_of_samples: Number of valid conversions in the sum (0 if none).
+ *******************************************************************/
+typedef void (*ANALOG_data_ready_cb_t)(ANALOG_channel_t channel, int64_t sum, uint32_t number_of_samples);
+
+/*!******************************************************************
+ * \enum ANALOG_capture_trigger_t
+ * \brief Capture trigger sources list.
+ *******************************************************************/
+typedef enum {
+    ANALOG_CAPTURE_TRIGGER_MANUAL = 0,
+    ANALOG_CAPTURE_TRIGGER_CURRENT_STEP,
+    ANALOG_CAPTURE_TRIGGER_VOLTAGE_DROOP,
+    ANALOG_CAPTURE_TRIGGER_LAST
+} ANALOG_capture_trigger_t;
+
+/*!******************************************************************
+ * \enum ANALOG_capture_state_t
+ * \brief Capture states list.
+ *******************************************************************/
+typedef enum {
+    ANALOG_CAPTURE_STATE_IDLE = 0,
+    ANALOG_CAPTURE_STATE_ARMED,
+    ANALOG_CAPTURE_STATE_TRIGGERED,
+    ANALOG_CAPTURE_STATE_COMPLETE,
+    ANALOG_CAPTURE_STATE_LAST
+} ANALOG_capture_state_t;
+
+/*!******************************************************************
+ * \struct ANALOG_capture_information_t
+ * \brief Capture buffer characteristics.
+ *******************************************************************/
+typedef struct {
+    ANALOG_capture_state_t state;
+    uint16_t number_of_samples;
+    uint16_t trigger_index;
+    uint32_t sampling_period_us;
+} ANALOG_capture_information_t;
+
+/*!******************************************************************
+ * \struct ANALOG_energy_t
+ * \brief Output charge and energy accumulated since last reset.
+ *******************************************************************/
+typedef struct {
+    uint64_t duration_us;
+    uint64_t output_charge_uah;
+    uint64_t output_energy_uwh;
+} ANALOG_energy_t;
+
+/*!******************************************************************
+ * \struct ANALOG_statistics_t
+ * \brief Channel statistics over a window.
+ *******************************************************************/
+typedef struct {
+    uint64_t start_time_us;
+    uint32_t number_of_samples;
+    int32_t min;
+    int32_t max;
+    int32_t mean;
+    uint64_t variance;
+    uint32_t rms;
+} ANALOG_statistics_t;
+
+/*!******************************************************************
+ * \enum ANALOG_alarm_t
+ * \brief Output limits alarms list.
+ *******************************************************************/
+typedef enum {
+    ANALOG_ALARM_OUTPUT_VOLTAGE_LOW = 0,
+    ANALOG_ALARM_OUTPUT_VOLTAGE_HIGH,
+    ANALOG_ALARM_OUTPUT_CURRENT_HIGH,
+    ANALOG_ALARM_LAST
+} ANALOG_alarm_t;
+
+/*!******************************************************************
+ * \struct ANALOG_alarm_information_t
+ * \brief Alarm configuration and latched event.
+ *******************************************************************/
+typedef struct {
+    uint8_t enable;
+    int32_t threshold;
+    uint8_t latched;
+    uint64_t timestamp_us;
+    int32_t value;
+} ANALOG_alarm_information_t;
+
+/*!******************************************************************
+ * \enum ANALOG_journal_event_t
+ * \brief Journal events list.
+ *******************************************************************/
+typedef enum {
+    ANALOG_JOURNAL_EVENT_OUTPUT_CURRENT_RANGE = 0,
+    ANALOG_JOURNAL_EVENT_BYPASS_ON,
+    ANALOG_JOURNAL_EVENT_BYPASS_OFF,
+    ANALOG_JOURNAL_EVENT_TRCS_START,
+    ANALOG_JOURNAL_EVENT_TRCS_STOP,
+    ANALOG_JOURNAL_EVENT_CALIBRATION,
+    ANALOG_JOURNAL_EVENT_LAST
+} ANALOG_journal_event_t;
+
+/*!******************************************************************
+ * \struct ANALOG_journal_entry_t
+ * \brief Journal event record.
+ *******************************************************************/
+typedef struct {
+    uint64_t timestamp_us;
+    ANALOG_journal_event_t event;
+    ANALOG_output_current_range_t output_current_range;
+    int32_t output_current_ua;
+} ANALOG_journal_entry_t;
+
+/*!******************************************************************
+ * \fn ANALOG_alarm_cb_t
+ * \brief Alarm notification callback (called from main loop).
+ * \param[in]   alarm: Alarm which has been latched.
+ *******************************************************************/
+typedef void (*ANALOG_alarm_cb_t)(ANALOG_alarm_t alarm);
+
 /*** ANALOG functions ***/
 
 /*!******************************************************************
@@ -85,7 +266,7 @@ ANALOG_status_t ANALOG_de_init(void);
 
 /*!******************************************************************
  * \fn ANALOG_status_t ANALOG_start_trcs(void)
- * \brief Start output current measurements.
+ * \brief Start output current measurements (the TRCS board runs while the bypass switch, polled every 10ms, is off).
  * \param[in]   none
  * \param[out]  none
  * \retval      Function execution status.
@@ -102,22 +283,72 @@ ANALOG_status_t ANALOG_start_trcs(void);
 ANALOG_status_t ANALOG_stop_trcs(void);
 
 /*!******************************************************************
- * \fn ANALOG_status_t ANALOG_process(void)
- * \brief Process ANALOG driver.
+ * \fn ANALOG_status_t ANALOG_read_channel(ANALOG_channel_t channel, int32_t* analog_data)
+ * \brief Get analog channel data.
+ * \param[in]   channel: Channel to read.
+ * \param[out]  analog_data: Pointer to integer that will contain the result.
+ * \retval      Function execution status.
+ *******************************************************************/
+ANALOG_status_t ANALOG_read_channel(ANALOG_channel_t channel, int32_t* analog_data);
+
+/*!******************************************************************
+ * \fn ANALOG_status_t ANALOG_read_snapshot(ANALOG_snapshot_t* snapshot)
+ * \brief Get all analog channels, current range and bypass state from the same acquisition.
  * \param[in]   none
+ * \param[out]  snapshot: Pointer to the snapshot that will contain the data. The timestamp is the system time of the last scan.
+ * \retval      Function execution status.
+ *******************************************************************/
+ANALOG_status_t ANALOG_read_snapshot(ANALOG_snapshot_t* snapshot);
+
+/*!******************************************************************
+ * \fn ANALOG_status_t ANALOG_set_filter(ANALOG_channel_t channel, ANALOG_filter_configuration_t* configuration)
+ * \brief Configure the filter of a channel (filtered values are published in the snapshot next to raw values).
+ * \param[in]   channel: Channel to filter.
+ * \param[in]   configuration: Pointer to the filter parameters: median_taps (1 to disable, 3 or 5), time_constant_ms (0 to disable low pass) and step_threshold (absolute deviation in channel unit which resets the low pass to the input, 0 to disable).
  * \param[out]  none
  * \retval      Function execution status.
  *******************************************************************/
-ANALOG_status_t ANALOG_process(void);
+ANALOG_status_t ANALOG_set_filter(ANALOG_channel_t channel, ANALOG_filter_configuration_t* configuration);
 
 /*!******************************************************************
- * \fn ANALOG_status_t ANALOG_read_channel(ANALOG_channel_t channel, int32_t* analog_data)
- * \brief Get analog channel data.
+ * \fn ANALOG_status_t ANALOG_subscribe(ANALOG_channel_t channel, uint16_t decimation, ANALOG_data_ready_cb_t data_ready_callback)
+ * \brief Register a callback called when a channel has new data.
+ * \param[in]   channel: Channel to monitor.
+ * \param[in]   decimation: Number of conversions between two notifications (1 to notify all conversions), which are averaged in the notified data.
+ * \param[in]   data_ready_callback: Function to call when new data is available.
+ * \param[out]  none
+ * \retval      Function execution status.
+ *******************************************************************/
+ANALOG_status_t ANALOG_subscribe(ANALOG_channel_t channel, uint16_t decimation, ANALOG_data_ready_cb_t data_ready_callback);
+
+/*!******************************************************************
+ * \fn ANALOG_status_t ANALOG_unsubscribe(ANALOG_channel_t channel, ANALOG_data_ready_cb_t data_ready_callback)
+ * \brief Remove a new data callback.
+ * \param[in]   channel: Monitored channel.
+ * \param[in]   data_ready_callback: Registered function.
+ * \param[out]  none
+ * \retval      Function execution status.
+ *******************************************************************/
+ANALOG_status_t ANALOG_unsubscribe(ANALOG_channel_t channel, ANALOG_data_ready_cb_t data_ready_callback);
+
+/*!******************************************************************
+ * \fn ANALOG_status_t ANALOG_read_raw_sum(ANALOG_channel_t channel, uint32_t* raw_sum, uint16_t* number_of_samples)
+ * \brief Get the last complete oversampling sum of an analog channel, before decimation.
  * \param[in]   channel: Channel to read.
- * \param[out]  analog_data: Pointer to integer that will contain the result.
+ * \param[out]  raw_sum: Pointer to integer that will contain the sum of the 12-bits ADC samples.
+ * \param[out]  number_of_samples: Pointer to integer that will contain the number of accumulated samples.
  * \retval      Function execution status.
  *******************************************************************/
-ANALOG_status_t ANALOG_read_channel(ANALOG_channel_t channel, int32_t* analog_data);
+ANALOG_status_t ANALOG_read_raw_sum(ANALOG_channel_t channel, uint32_t* raw_sum, uint16_t* number_of_samples);
+
+/*!******************************************************************
+ * \fn ANALOG_status_t ANALOG_convert_output_current(int32_t* output_current_mv)
+ * \brief Restart the output current oversampling and busy wait for a conversion entirely sampled after the call (typically 2ms, timeout 4ms, main context only).
+ * \param[in]   none
+ * \param[out]  output_current_mv: Pointer to integer that will contain the TRCS output voltage in mV.
+ * \retval      Function execution status.
+ *******************************************************************/
+ANALOG_status_t ANALOG_convert_output_current(int32_t* output_current_mv);
 
 /*!******************************************************************
  * \fn ANALOG_status_t ANALOG_get_bypass_switch_state(uint8_t* bypass_switch_state)
@@ -137,6 +368,203 @@ ANALOG_status_t ANALOG_get_bypass_switch_state(uint8_t* bypass_switch_state);
  *******************************************************************/
 ANALOG_status_t ANALOG_get_output_current_range(ANALOG_output_current_range_t* output_current_range);
 
+/*!******************************************************************
+ * \fn ANALOG_status_t ANALOG_arm_capture(ANALOG_capture_trigger_t trigger, int32_t threshold_mv, uint16_t pre_trigger_samples)
+ * \brief Start recording output voltage and current samples and wait for a trigger.
+ * \param[in]   trigger: Trigger source.
+ * \param[in]   threshold_mv: Current channel step (for current step trigger) or output voltage level (for voltage droop trigger) in mV.
+ * \param[in]   pre_trigger_samples: Number of samples kept before the trigger.
+ * \param[out]  none
+ * \retval      Function execution status.
+ *******************************************************************/
+ANALOG_status_t ANALOG_arm_capture(ANALOG_capture_trigger_t trigger, int32_t threshold_mv, uint16_t pre_trigger_samples);
+
+/*!******************************************************************
+ * \fn ANALOG_status_t ANALOG_trigger_capture(void)
+ * \brief Force capture trigger.
+ * \param[in]   none
+ * \param[out]  none
+ * \retval      Function execution status.
+ *******************************************************************/
+ANALOG_status_t ANALOG_trigger_capture(void);
+
+/*!******************************************************************
+ * \fn ANALOG_status_t ANALOG_get_capture_information(ANALOG_capture_information_t* capture_information)
+ * \brief Get capture state and buffer characteristics.
+ * \param[in]   none
+ * \param[out]  capture_information: Pointer to the capture information.
+ * \retval      Function execution status.
+ *******************************************************************/
+ANALOG_status_t ANALOG_get_capture_information(ANALOG_capture_information_t* capture_information);
+
+/*!******************************************************************
+ * \fn ANALOG_status_t ANALOG_read_capture_sample(uint16_t sample_index, int32_t* output_voltage_mv, int32_t* output_current_mv)
+ * \brief Read a sample of the completed capture.
+ * \param[in]   sample_index: Sample index from the oldest one.
+ * \param[out]  output_voltage_mv: Pointer to integer that will contain the output voltage in mV.
+ * \param[out]  output_current_mv: Pointer to integer that will contain the current channel voltage in mV.
+ * \retval      Function execution status.
+ *******************************************************************/
+ANALOG_status_t ANALOG_read_capture_sample(uint16_t sample_index, int32_t* output_voltage_mv, int32_t* output_current_mv);
+
+/*!******************************************************************
+ * \fn ANALOG_status_t ANALOG_reset_energy(void)
+ * \brief Reset output charge and energy accumulators.
+ * \param[in]   none
+ * \param[out]  none
+ * \retval      Function execution status.
+ *******************************************************************/
+ANALOG_status_t ANALOG_reset_energy(void);
+
+/*!******************************************************************
+ * \fn ANALOG_status_t ANALOG_read_energy(ANALOG_energy_t* energy)
+ * \brief Read output charge and energy accumulated since last reset (integrated every 1ms with the last TRCS sample held, suspended while the bypass switch is on).
+ * \param[in]   none
+ * \param[out]  energy: Pointer to the accumulated charge and energy.
+ * \retval      Function execution status.
+ *******************************************************************/
+ANALOG_status_t ANALOG_read_energy(ANALOG_energy_t* energy);
+
+/*!******************************************************************
+ * \fn ANALOG_status_t ANALOG_open_statistics(ANALOG_channel_t channel, uint8_t* statistics_id)
+ * \brief Start computing statistics of a channel (window starts on open and on each reset, output current and power samples are the last TRCS sample held at 1kHz).
+ * \param[in]   channel: Channel to monitor.
+ * \param[out]  statistics_id: Pointer to the identifier to use for read and close.
+ * \retval      Function execution status.
+ *******************************************************************/
+ANALOG_status_t ANALOG_open_statistics(ANALOG_channel_t channel, uint8_t* statistics_id);
+
+/*!******************************************************************
+ * \fn ANALOG_status_t ANALOG_close_statistics(uint8_t statistics_id)
+ * \brief Stop computing statistics.
+ * \param[in]   statistics_id: Identifier returned by the open function.
+ * \param[out]  none
+ * \retval      Function execution status.
+ *******************************************************************/
+ANALOG_status_t ANALOG_close_statistics(uint8_t statistics_id);
+
+/*!******************************************************************
+ * \fn ANALOG_status_t ANALOG_read_statistics(uint8_t statistics_id, uint8_t reset, ANALOG_statistics_t* statistics)
+ * \brief Read channel statistics since the last reset.
+ * \param[in]   statistics_id: Identifier returned by the open function.
+ * \param[in]   reset: Start a new window if non zero (no sample is lost nor counted twice).
+ * \param[out]  statistics: Pointer to the statistics of the window.
+ * \retval      Function execution status.
+ *******************************************************************/
+ANALOG_status_t ANALOG_read_statistics(uint8_t statistics_id, uint8_t reset, ANALOG_statistics_t* statistics);
+
+/*!******************************************************************
+ * \fn ANALOG_status_t ANALOG_reset_output_current_quantiles(void)
+ * \brief Clear output current distribution (effective on next TRCS sample).
+ * \param[in]   none
+ * \param[out]  none
+ * \retval      Function execution status.
+ *******************************************************************/
+ANALOG_status_t ANALOG_reset_output_current_quantiles(void);
+
+/*!******************************************************************
+ * \fn ANALOG_status_t ANALOG_read_output_current_quantile(uint16_t quantile_permille, int32_t* output_current_ua, uint32_t* number_of_samples)
+ * \brief Estimate an output current quantile since last reset (relative error below 7%).
+ * \param[in]   quantile_permille: Quantile to compute in per mille (500 for median, 990 for P99).
+ * \param[out]  output_current_ua: Pointer to the estimated output current in uA.
+ * \param[out]  number_of_samples: Pointer to the number of TRCS samples since last reset (one per TRCS sampling period).
+ * \retval      Function execution status.
+ *******************************************************************/
+ANALOG_status_t ANALOG_read_output_current_quantile(uint16_t quantile_permille, int32_t* output_current_ua, uint32_t* number_of_samples);
+
+/*!******************************************************************
+ * \fn ANALOG_status_t ANALOG_set_spectrum_bin(uint8_t bin_index, uint16_t frequency_hz)
+ * \brief Configure a Goertzel filter on the output ripple bursts (bins 0 and 1 default to 100Hz and 120Hz).
+ * \param[in]   bin_index: Bin to configure.
+ * \param[in]   frequency_hz: Bin frequency in Hz (10 to 1990), 0 to disable the bin.
+ * \param[out]  none
+ * \retval      Function execution status.
+ *******************************************************************/
+ANALOG_status_t ANALOG_set_spectrum_bin(uint8_t bin_index, uint16_t frequency_hz);
+
+/*!******************************************************************
+ * \fn ANALOG_status_t ANALOG_read_spectrum_bin(uint8_t bin_index, uint16_t* frequency_hz, int32_t* amplitude_mv)
+ * \brief Read the output voltage amplitude measured by a spectrum bin on the last ripple burst.
+ * \param[in]   bin_index: Bin to read.
+ * \param[out]  frequency_hz: Pointer to the bin frequency in Hz (0 if disabled).
+ * \param[out]  amplitude_mv: Pointer to the peak amplitude in mV (ANALOG_ERROR_VALUE if not available yet).
+ * \retval      Function execution status.
+ *******************************************************************/
+ANALOG_status_t ANALOG_read_spectrum_bin(uint8_t bin_index, uint16_t* frequency_hz, int32_t* amplitude_mv);
+
+/*!******************************************************************
+ * \fn ANALOG_status_t ANALOG_get_journal_sequence(uint32_t* sequence)
+ * \brief Get the number of events recorded in the journal since init.
+ * \param[in]   none
+ * \param[out]  sequence: Pointer to the sequence number of the next event.
+ * \retval      Function execution status.
+ *******************************************************************/
+ANALOG_status_t ANALOG_get_journal_sequence(uint32_t* sequence);
+
+/*!******************************************************************
+ * \fn ANALOG_status_t ANALOG_read_journal_entry(uint32_t sequence, ANALOG_journal_entry_t* journal_entry)
+ * \brief Read a journal event (only the last ANALOG_JOURNAL_DEPTH events are kept).
+ * \param[in]   sequence: Sequence number of the event.
+ * \param[out]  journal_entry: Pointer to the event record (range after the event and last output current measured before it).
+ * \retval      Function execution status.
+ *******************************************************************/
+ANALOG_status_t ANALOG_read_journal_entry(uint32_t sequence, ANALOG_journal_entry_t* journal_entry);
+
+/*!******************************************************************
+ * \fn ANALOG_status_t ANALOG_set_alarm(ANALOG_alarm_t alarm, int32_t threshold)
+ * \brief Enable an alarm. Output voltage alarms use the ADC analog watchdog. Output current alarm checks each raw scan against the threshold converted with the gain learned from the TRCS samples (reaction within 2 scans, processed on the 1ms block interrupt), and each TRCS sample for ranges without learned gain.
+ * \param[in]   alarm: Alarm to configure.
+ * \param[in]   threshold: Output voltage limit in mV or output current limit in uA.
+ * \param[out]  none
+ * \retval      Function execution status.
+ *******************************************************************/
+ANALOG_status_t ANALOG_set_alarm(ANALOG_alarm_t alarm, int32_t threshold);
+
+/*!******************************************************************
+ * \fn ANALOG_status_t ANALOG_disable_alarm(ANALOG_alarm_t alarm)
+ * \brief Disable an alarm.
+ * \param[in]   alarm: Alarm to disable.
+ * \param[out]  none
+ * \retval      Function execution status.
+ *******************************************************************/
+ANALOG_status_t ANALOG_disable_alarm(ANALOG_alarm_t alarm);
+
+/*!******************************************************************
+ * \fn ANALOG_status_t ANALOG_acknowledge_alarm(ANALOG_alarm_t alarm)
+ * \brief Clear a latched alarm and re-arm it.
+ * \param[in]   alarm: Alarm to acknowledge.
+ * \param[out]  none
+ * \retval      Function execution status.
+ *******************************************************************/
+ANALOG_status_t ANALOG_acknowledge_alarm(ANALOG_alarm_t alarm);
+
+/*!******************************************************************
+ * \fn ANALOG_status_t ANALOG_get_alarm(ANALOG_alarm_t alarm, ANALOG_alarm_information_t* alarm_information)
+ * \brief Get alarm configuration and latched event.
+ * \param[in]   alarm: Alarm to read.
+ * \param[out]  alarm_information: Pointer to the alarm information.
+ * \retval      Function execution status.
+ *******************************************************************/
+ANALOG_status_t ANALOG_get_alarm(ANALOG_alarm_t alarm, ANALOG_alarm_information_t* alarm_information);
+
+/*!******************************************************************
+ * \fn ANALOG_status_t ANALOG_register_alarm_callback(ANALOG_alarm_cb_t alarm_callback)
+ * \brief Register a function called when an alarm is latched.
+ * \param[in]   alarm_callback: Function to call.
+ * \param[out]  none
+ * \retval      Function execution status.
+ *******************************************************************/
+ANALOG_status_t ANALOG_register_alarm_callback(ANALOG_alarm_cb_t alarm_callback);
+
+/*!******************************************************************
+ * \fn ANALOG_status_t ANALOG_unregister_alarm_callback(ANALOG_alarm_cb_t alarm_callback)
+ * \brief Unregister an alarm callback.
+ * \param[in]   alarm_callback: Function to remove.
+ * \param[out]  none
+ * \retval      Function execution status.
+ *******************************************************************/
+ANALOG_status_t ANALOG_unregister_alarm_callback(ANALOG_alarm_cb_t alarm_callback);
+
 /*******************************************************************/
 #define ANALOG_exit_error(base) { ERROR_check_exit(analog_status, ANALOG_SUCCESS, base) }
 
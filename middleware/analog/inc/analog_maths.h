@@ -0,0 +1,74 @@
+/*
+ * analog_maths.h
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef __ANALOG_MATHS_H__
+#define __ANALOG_MATHS_H__
+
+#include "types.h"
+
+/*** ANALOG MATHS structures ***/
+
+/*!******************************************************************
+ * \struct ANALOG_MATHS_reciprocal_t
+ * \brief Precomputed reciprocal of a divisor (x / divisor = (x * multiplier) >> shift).
+ *******************************************************************/
+typedef struct {
+    uint32_t multiplier;
+    uint8_t shift;
+} ANALOG_MATHS_reciprocal_t;
+
+/*** ANALOG MATHS functions ***/
+
+/*!******************************************************************
+ * \fn uint8_t ANALOG_MATHS_get_bit_length(uint32_t value)
+ * \brief Compute the number of significant bits of a value.
+ * \param[in]   value: Value to analyze.
+ * \param[out]  none
+ * \retval      Number of significant bits.
+ *******************************************************************/
+uint8_t ANALOG_MATHS_get_bit_length(uint32_t value);
+
+/*!******************************************************************
+ * \fn void ANALOG_MATHS_compute_reciprocal(uint32_t divisor, uint32_t dividend_max, ANALOG_MATHS_reciprocal_t* reciprocal)
+ * \brief Compute the reciprocal of a divisor (exact division for any dividend up to dividend_max).
+ * \param[in]   divisor: Divisor (must not be 0).
+ * \param[in]   dividend_max: Maximum dividend which will be divided.
+ * \param[out]  reciprocal: Pointer to the reciprocal to compute.
+ * \retval      none
+ *******************************************************************/
+void ANALOG_MATHS_compute_reciprocal(uint32_t divisor, uint32_t dividend_max, ANALOG_MATHS_reciprocal_t* reciprocal);
+
+/*!******************************************************************
+ * \fn uint32_t ANALOG_MATHS_divide(uint32_t dividend, ANALOG_MATHS_reciprocal_t* reciprocal)
+ * \brief Divide a value with a precomputed reciprocal.
+ * \param[in]   dividend: Dividend (must not exceed the dividend_max of the reciprocal).
+ * \param[in]   reciprocal: Pointer to the divisor reciprocal.
+ * \param[out]  none
+ * \retval      Quotient (rounded toward zero).
+ *******************************************************************/
+uint32_t ANALOG_MATHS_divide(uint32_t dividend, ANALOG_MATHS_reciprocal_t* reciprocal);
+
+/*!******************************************************************
+ * \fn int32_t ANALOG_MATHS_divide_signed(int32_t dividend, ANALOG_MATHS_reciprocal_t* reciprocal)
+ * \brief Divide a signed value with a precomputed reciprocal.
+ * \param[in]   dividend: Dividend (absolute value must not exceed the dividend_max of the reciprocal).
+ * \param[in]   reciprocal: Pointer to the divisor reciprocal.
+ * \param[out]  none
+ * \retval      Quotient (rounded toward zero like the C division).
+ *******************************************************************/
+int32_t ANALOG_MATHS_divide_signed(int32_t dividend, ANALOG_MATHS_reciprocal_t* reciprocal);
+
+/*!******************************************************************
+ * \fn uint32_t ANALOG_MATHS_sqrt(uint64_t value)
+ * \brief Compute the integer square root of a value.
+ * \param[in]   value: Value to process.
+ * \param[out]  none
+ * \retval      Square root rounded down.
+ *******************************************************************/
+uint32_t ANALOG_MATHS_sqrt(uint64_t value);
+
+#endif /* __ANALOG_MATHS_H__ */
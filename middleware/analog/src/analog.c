@@ -8,31 +8,291 @@
 #include "analog.h"
 
 #include "adc.h"
+#include "analog_maths.h"
+#include "adc_scan.h"
 #include "error.h"
 #include "error_base.h"
+#include "event.h"
 #include "gpio.h"
 #include "mcu_mapping.h"
 #include "nvic_priority.h"
 #include "nvm.h"
 #include "nvm_address.h"
 #include "psfe_flags.h"
-#include "rtc.h"
-#include "tim.h"
+#include "timer.h"
 #include "trcs.h"
 #include "types.h"
 
 /*** ANALOG local macros ***/
 
-#define ANALOG_TIMER_PERIOD_MS                  100
+// Scheduler timebase: all channel rates are multiples of the scan period.
+#define ANALOG_SCAN_PERIOD_US                   250
+// Scans are processed by blocks of one output current period, which bounds the output current data latency to 2 blocks.
+#define ANALOG_SCAN_NUMBER_OF_SCANS_PER_BLOCK   ANALOG_OUTPUT_CURRENT_PERIOD_SCANS
+#define ANALOG_SCAN_CHANNEL_MASK                ((0b1 << ADC_CHANNEL_OUTPUT_CURRENT) | (0b1 << ADC_CHANNEL_OUTPUT_VOLTAGE) | (0b1 << ADC_CHANNEL_REF191) | (0b1 << ADC_CHANNEL_VREFINT) | (0b1 << ADC_CHANNEL_TEMPERATURE_SENSOR))
+
+#define ANALOG_ADC_RESOLUTION_BITS              12
+#define ANALOG_ADC_FULL_SCALE                   ((0b1 << ANALOG_ADC_RESOLUTION_BITS) - 1)
+
+// Periods are expressed in scans. The last (ratio) samples of each period are accumulated and shifted, giving (12 + log2(ratio) - shift) bits data.
+#define ANALOG_OUTPUT_CURRENT_PERIOD_SCANS      4
+#define ANALOG_OUTPUT_CURRENT_RATIO             4
+#define ANALOG_OUTPUT_CURRENT_SHIFT             1
+#define ANALOG_OUTPUT_CURRENT_SAMPLING_TIME     ADC_SCAN_SAMPLING_TIME_39_5_CYCLES
+#define ANALOG_OUTPUT_CURRENT_TIMEOUT_US        (4 * ANALOG_SCAN_NUMBER_OF_SCANS_PER_BLOCK * ANALOG_SCAN_PERIOD_US)
+#define ANALOG_OUTPUT_VOLTAGE_PERIOD_SCANS      40
+#define ANALOG_OUTPUT_VOLTAGE_RATIO             32
+#define ANALOG_OUTPUT_VOLTAGE_SHIFT             2
+#define ANALOG_OUTPUT_VOLTAGE_SAMPLING_TIME     ADC_SCAN_SAMPLING_TIME_39_5_CYCLES
+#define ANALOG_REF191_PERIOD_SCANS              4000
+#define ANALOG_REF191_RATIO                     16
+#define ANALOG_REF191_SHIFT                     4
+#define ANALOG_REF191_SAMPLING_TIME             ADC_SCAN_SAMPLING_TIME_39_5_CYCLES
+// Internal reference and temperature sensor require at least 10us of sampling time.
+#define ANALOG_VREFINT_PERIOD_SCANS             4000
+#define ANALOG_VREFINT_RATIO                    16
+#define ANALOG_VREFINT_SHIFT                    4
+#define ANALOG_VREFINT_SAMPLING_TIME            ADC_SCAN_SAMPLING_TIME_160_5_CYCLES
+#define ANALOG_TEMPERATURE_PERIOD_SCANS         40000
+#define ANALOG_TEMPERATURE_RATIO                16
+#define ANALOG_TEMPERATURE_SHIFT                4
+#define ANALOG_TEMPERATURE_SAMPLING_TIME        ADC_SCAN_SAMPLING_TIME_160_5_CYCLES
 
 #define ANALOG_REF191_VOLTAGE_MV                2048
 
-#define ANALOG_CALIBRATION_PERIOD_SECONDS       300
+// Factory calibration of the temperature sensor (30 and 130 degrees at VDDA=3V).
+#define ANALOG_TS_CAL1_ADDRESS                  ((volatile uint16_t*) 0x1FF8007A)
+#define ANALOG_TS_CAL2_ADDRESS                  ((volatile uint16_t*) 0x1FF8007E)
+#define ANALOG_TS_CAL1_TEMPERATURE_DEGREES      30
+#define ANALOG_TS_CAL2_TEMPERATURE_DEGREES      130
+#define ANALOG_TS_CAL_VDDA_MV                   3000
+#define ANALOG_MCU_VOLTAGE_MV_MAX               0xFFFF
+
+// Output power: uW = (mV * uA) / 1000 = (mV * uA * ceil(2^30 / 1000)) >> 30, exact enough while the product fits 64 bits.
+#define ANALOG_OUTPUT_POWER_MULTIPLIER          1073742
+#define ANALOG_OUTPUT_POWER_SHIFT               30
+#define ANALOG_OUTPUT_POWER_CURRENT_UA_MAX      0x07FFFFFF
+#define ANALOG_OUTPUT_POWER_UW_MAX              (ANALOG_ERROR_VALUE - 1)
+// Charge and energy are integrated on each output current conversion.
+#define ANALOG_ENERGY_PERIOD_US                 (ANALOG_OUTPUT_CURRENT_PERIOD_SCANS * ANALOG_SCAN_PERIOD_US)
+#define ANALOG_ENERGY_PERIODS_PER_HOUR          (3600000000UL / ANALOG_ENERGY_PERIOD_US)
+
+// Output ripple: single pass on a burst of consecutive raw output voltage samples at the end of each period (burst length must be a power of 2).
+#define ANALOG_RIPPLE_PERIOD_SCANS              4000
+#define ANALOG_RIPPLE_BURST_SCANS_LOG2          9
+#define ANALOG_RIPPLE_BURST_SCANS               (0b1 << ANALOG_RIPPLE_BURST_SCANS_LOG2)
+
+// Spectrum: Goertzel filters run on the output ripple bursts, coefficients are computed in Q30 from a phase expressed on 2^24 per turn.
+#define ANALOG_SPECTRUM_SAMPLING_FREQUENCY_HZ   (1000000 / ANALOG_SCAN_PERIOD_US)
+#define ANALOG_SPECTRUM_FREQUENCY_MIN_HZ        10
+#define ANALOG_SPECTRUM_FREQUENCY_MAX_HZ        ((ANALOG_SPECTRUM_SAMPLING_FREQUENCY_HZ >> 1) - ANALOG_SPECTRUM_FREQUENCY_MIN_HZ)
+#define ANALOG_SPECTRUM_DEFAULT_BIN_0_HZ        100
+#define ANALOG_SPECTRUM_DEFAULT_BIN_1_HZ        120
+#define ANALOG_SPECTRUM_PHASE_BITS              24
+#define ANALOG_SPECTRUM_FRACTIONAL_BITS         30
+#define ANALOG_SPECTRUM_TWO_PI                  6746518852ULL
+#define ANALOG_SPECTRUM_SERIES_ORDER            5
+#define ANALOG_SPECTRUM_COEFFICIENT_BITS        28
+
+#define ANALOG_SUBSCRIPTIONS_MAX                6
+#define ANALOG_ALARM_CALLBACKS_MAX              3
+#define ANALOG_STATISTICS_MAX                   3
+#define ANALOG_STATISTICS_DEVIATION_MAX         0xFFFF
+
+// Output current distribution: log2 histogram with 2^(sub bucket bits) linear sub-buckets per octave.
+#define ANALOG_QUANTILE_VALUE_BITS              27
+#define ANALOG_QUANTILE_VALUE_MAX               ((0b1 << ANALOG_QUANTILE_VALUE_BITS) - 1)
+#define ANALOG_QUANTILE_SUB_BUCKET_BITS         3
+#define ANALOG_QUANTILE_SUB_BUCKETS             (0b1 << ANALOG_QUANTILE_SUB_BUCKET_BITS)
+#define ANALOG_QUANTILE_NUMBER_OF_BUCKETS       ((ANALOG_QUANTILE_VALUE_BITS - ANALOG_QUANTILE_SUB_BUCKET_BITS + 1) << ANALOG_QUANTILE_SUB_BUCKET_BITS)
+#define ANALOG_QUANTILE_BUCKET_COUNT_MAX        0xFFFF
+#define ANALOG_QUANTILE_PERMILLE_MAX            1000
+
+#define ANALOG_FILTER_MEDIAN_TAPS_MAX           5
+#define ANALOG_FILTER_FRACTIONAL_BITS           8
+#define ANALOG_FILTER_ALPHA_BITS                16
 
-#define ANALOG_ERROR_VALUE                      0x7FFFFFFF
+// Capture buffer depth must be a power of 2.
+#define ANALOG_CAPTURE_DEPTH                    128
+#define ANALOG_CAPTURE_STEP_DELAY_SCANS         4
+
+// Background calibration: each REF191 conversion is folded into an exponential average (fractional bits cover the oversampling ratio).
+#define ANALOG_CALIBRATION_FRACTIONAL_BITS      8
+#define ANALOG_CALIBRATION_SLOW_SHIFT           4
+#define ANALOG_CALIBRATION_FAST_SHIFT           1
+#define ANALOG_CALIBRATION_FAST_CONVERSIONS     8
+#define ANALOG_CALIBRATION_OUTLIER_THRESHOLD    (16 << ANALOG_CALIBRATION_FRACTIONAL_BITS)
+#define ANALOG_CALIBRATION_OUTLIER_COUNT_MAX    4
+#define ANALOG_CALIBRATION_VREFINT_DRIFT        4
+#define ANALOG_CALIBRATION_TEMPERATURE_DRIFT    5
+
+// Output current and power are held during a settling window after each range change (expressed in output current periods, including the switching one).
+#define ANALOG_BLANKING_PERIOD_US               (ANALOG_OUTPUT_CURRENT_PERIOD_SCANS * ANALOG_SCAN_PERIOD_US)
+#define ANALOG_BLANKING_RANGE_LOW_US            5000
+#define ANALOG_BLANKING_RANGE_MIDDLE_US         2000
+#define ANALOG_BLANKING_RANGE_HIGH_US           1000
+#define ANALOG_BLANKING_CHANNEL_MASK            ((0b1 << ANALOG_CHANNEL_OUTPUT_CURRENT_UA) | (0b1 << ANALOG_CHANNEL_OUTPUT_POWER_UW))
+// Output current alarm.
+#define ANALOG_CURRENT_GAIN_FRACTIONAL_BITS     8
+#define ANALOG_CURRENT_GAIN_DATA_MIN            256
+#define ANALOG_CURRENT_GAIN_FILTER_SHIFT        2
+#define ANALOG_CURRENT_ALARM_DISARMED           0xFFFF
+#define ANALOG_CURRENT_ALARM_SCANS              2
+
+// Bypass switch polling (the TRCS board is started and stopped accordingly).
+#define ANALOG_BYPASS_PERIOD_MS                 10
+// Journal depth must be a power of 2.
+#define ANALOG_JOURNAL_INDEX_MASK               (ANALOG_JOURNAL_DEPTH - 1)
 
 /*** ANALOG local structures ***/
 
+/*******************************************************************/
+typedef enum {
+    // Samples are stored by ascending ADC channel number.
+    ANALOG_SCAN_INDEX_OUTPUT_CURRENT = 0,
+    ANALOG_SCAN_INDEX_OUTPUT_VOLTAGE,
+    ANALOG_SCAN_INDEX_REF191,
+    ANALOG_SCAN_INDEX_VREFINT,
+    ANALOG_SCAN_INDEX_TEMPERATURE,
+    ANALOG_SCAN_INDEX_LAST
+} ANALOG_scan_index_t;
+
+/*******************************************************************/
+typedef enum {
+    ANALOG_OUTPUT_CURRENT_RESTART_STATE_IDLE = 0,
+    ANALOG_OUTPUT_CURRENT_RESTART_STATE_REQUESTED,
+    ANALOG_OUTPUT_CURRENT_RESTART_STATE_SCHEDULED,
+    ANALOG_OUTPUT_CURRENT_RESTART_STATE_LAST
+} ANALOG_output_current_restart_state_t;
+
+/*******************************************************************/
+typedef struct {
+    uint16_t period_scans;
+    uint16_t ratio;
+    uint8_t shift;
+    ADC_SCAN_sampling_time_t sampling_time;
+} ANALOG_rate_t;
+
+/*******************************************************************/
+typedef struct {
+    uint16_t scan_count;
+    uint32_t sum;
+    volatile uint32_t raw_sum;
+    int32_t data;
+    uint8_t resolution_bits;
+} ANALOG_oversampling_t;
+
+/*******************************************************************/
+typedef struct {
+    ANALOG_channel_t channel;
+    uint16_t decimation;
+    uint16_t count;
+    uint8_t origin_valid;
+    int64_t integrator_origin;
+    uint32_t number_of_samples_origin;
+    volatile ANALOG_data_ready_cb_t data_ready_callback;
+} ANALOG_subscription_t;
+
+/*******************************************************************/
+typedef struct {
+    uint16_t output_voltage_data_12bits;
+    uint16_t output_current_data_12bits;
+} ANALOG_capture_sample_t;
+
+/*******************************************************************/
+typedef struct {
+    volatile ANALOG_capture_state_t state;
+    ANALOG_capture_trigger_t trigger;
+    uint16_t threshold_data_12bits;
+    uint16_t pre_trigger_samples;
+    uint16_t sample_count;
+    uint16_t post_trigger_count;
+    uint16_t write_index;
+    uint16_t trigger_index;
+    ANALOG_capture_sample_t buffer[ANALOG_CAPTURE_DEPTH];
+} ANALOG_capture_t;
+
+/*******************************************************************/
+typedef struct {
+    uint16_t scan_count;
+    uint16_t first_data_12bits;
+    uint16_t min_data_12bits;
+    uint16_t max_data_12bits;
+    int32_t sum;
+    uint64_t sum_of_squares;
+    int32_t peak_to_peak_data;
+    int32_t rms_data;
+} ANALOG_ripple_t;
+
+/*******************************************************************/
+typedef struct {
+    volatile uint8_t enable;
+    volatile uint8_t active;
+    uint16_t frequency_hz;
+    int32_t coefficient;
+    int32_t s1;
+    int32_t s2;
+    volatile int32_t amplitude_mv;
+} ANALOG_spectrum_bin_t;
+
+/*******************************************************************/
+typedef struct {
+    uint64_t number_of_periods;
+    uint64_t output_charge_ua_periods;
+    uint64_t output_energy_uw_periods;
+} ANALOG_energy_accumulator_t;
+
+/*******************************************************************/
+typedef struct {
+    volatile uint8_t enable;
+    uint8_t median_taps;
+    uint32_t alpha;
+    int32_t step_threshold;
+    int32_t history[ANALOG_FILTER_MEDIAN_TAPS_MAX];
+    uint8_t history_index;
+    uint8_t history_count;
+    int64_t output;
+} ANALOG_filter_t;
+
+/*******************************************************************/
+typedef struct {
+    uint64_t start_time_us;
+    uint32_t number_of_samples;
+    int32_t min;
+    int32_t max;
+    int32_t offset;
+    int64_t sum;
+    uint64_t sum_of_squares;
+    uint8_t square_shift;
+} ANALOG_statistics_window_t;
+
+/*******************************************************************/
+typedef struct {
+    volatile uint8_t enable;
+    ANALOG_channel_t channel;
+    volatile uint8_t active_window;
+    ANALOG_statistics_window_t window[2];
+} ANALOG_statistics_slot_t;
+
+/*******************************************************************/
+typedef struct {
+    uint8_t enable;
+    int32_t threshold;
+    uint16_t threshold_data_12bits;
+    volatile uint8_t latched;
+    uint8_t notified;
+    uint64_t timestamp_us;
+    int32_t value;
+} ANALOG_alarm_entry_t;
+
+/*******************************************************************/
+typedef struct {
+    uint64_t timestamp_us;
+    int32_t output_current_ua;
+    uint8_t event;
+    uint8_t output_current_range;
+} ANALOG_journal_record_t;
+
 /*******************************************************************/
 typedef union {
     uint8_t all;
@@ -50,47 +310,480 @@ typedef struct {
     int32_t output_voltage_divider_resistance_ohms;
     volatile ANALOG_flags_t flags;
     int32_t data[ANALOG_CHANNEL_LAST];
+    int32_t filtered_data[ANALOG_CHANNEL_LAST];
+    ANALOG_filter_t filter[ANALOG_CHANNEL_LAST];
+    int64_t integrator[ANALOG_CHANNEL_LAST];
+    uint32_t integrator_number_of_samples[ANALOG_CHANNEL_LAST];
     int32_t ref191_data_12bits;
-    uint32_t calibration_next_time_seconds;
+    uint32_t ref191_average;
+    uint32_t ref191_applied_data;
+    uint8_t calibration_outlier_count;
+    uint8_t calibration_fast_count;
+    int32_t calibration_vrefint_data_12bits;
+    int32_t calibration_temperature_degrees;
+    ANALOG_MATHS_reciprocal_t output_voltage_reciprocal;
+    ANALOG_MATHS_reciprocal_t output_voltage_aligned_reciprocal;
+    ANALOG_MATHS_reciprocal_t output_current_reciprocal;
+    ANALOG_MATHS_reciprocal_t output_voltage_divider_resistance_reciprocal;
+    ANALOG_MATHS_reciprocal_t mcu_temperature_reciprocal;
+    ANALOG_MATHS_reciprocal_t output_voltage_threshold_reciprocal;
+    int32_t ts_cal1_data_scaled;
+    ANALOG_oversampling_t oversampling[ANALOG_SCAN_INDEX_LAST];
+    uint32_t output_voltage_aligned_sum;
+    uint32_t output_voltage_aligned_raw_sum;
+    volatile ANALOG_output_current_restart_state_t output_current_restart_state;
+    volatile uint32_t output_current_sequence;
+    volatile uint32_t output_current_restart_sequence;
+    volatile int32_t trcs_output_current_ua;
+    volatile ANALOG_output_current_range_t trcs_output_current_range;
+    volatile uint32_t trcs_sequence;
+    uint32_t trcs_converted_sequence;
+    uint8_t trcs_sample_update;
+    uint32_t output_current_gain[ANALOG_OUTPUT_CURRENT_RANGE_LAST];
+    volatile uint16_t output_current_threshold_data_12bits[ANALOG_OUTPUT_CURRENT_RANGE_LAST];
+    uint8_t output_current_alarm_count;
+    volatile uint32_t energy_sequence;
+    ANALOG_energy_accumulator_t energy;
+    ANALOG_energy_accumulator_t energy_origin;
+    ANALOG_capture_t capture;
+    ANALOG_ripple_t ripple;
+    ANALOG_spectrum_bin_t spectrum[ANALOG_SPECTRUM_NUMBER_OF_BINS];
+    uint64_t timestamp_us;
+    volatile uint32_t snapshot_sequence;
+    volatile ANALOG_snapshot_t snapshot[2];
+    ANALOG_subscription_t subscriptions[ANALOG_SUBSCRIPTIONS_MAX];
+    volatile uint32_t statistics_sequence;
+    ANALOG_statistics_slot_t statistics[ANALOG_STATISTICS_MAX];
+    volatile uint8_t quantile_reset_request;
+    volatile uint32_t quantile_number_of_samples;
+    volatile uint16_t quantile_histogram[ANALOG_QUANTILE_NUMBER_OF_BUCKETS];
+    ANALOG_alarm_entry_t alarms[ANALOG_ALARM_LAST];
+    volatile ANALOG_alarm_cb_t alarm_callbacks[ANALOG_ALARM_CALLBACKS_MAX];
+    ANALOG_flags_t journal_flags;
+    ANALOG_output_current_range_t journal_output_current_range;
+    int32_t journal_output_current_ua;
+    volatile uint32_t journal_sequence;
+    uint8_t blanking_count;
+    uint8_t output_current_valid;
+    TIMER_t bypass_timer;
+    ANALOG_journal_record_t journal[ANALOG_JOURNAL_DEPTH];
+    uint16_t scan_buffer[ANALOG_SCAN_NUMBER_OF_SCANS_PER_BLOCK * ANALOG_SCAN_INDEX_LAST * 2];
 } ANALOG_context_t;
 
 /*** ANALOG local global variables ***/
 
+static const ANALOG_rate_t ANALOG_RATE[ANALOG_SCAN_INDEX_LAST] = {
+    { ANALOG_OUTPUT_CURRENT_PERIOD_SCANS, ANALOG_OUTPUT_CURRENT_RATIO, ANALOG_OUTPUT_CURRENT_SHIFT, ANALOG_OUTPUT_CURRENT_SAMPLING_TIME },
+    { ANALOG_OUTPUT_VOLTAGE_PERIOD_SCANS, ANALOG_OUTPUT_VOLTAGE_RATIO, ANALOG_OUTPUT_VOLTAGE_SHIFT, ANALOG_OUTPUT_VOLTAGE_SAMPLING_TIME },
+    { ANALOG_REF191_PERIOD_SCANS, ANALOG_REF191_RATIO, ANALOG_REF191_SHIFT, ANALOG_REF191_SAMPLING_TIME },
+    { ANALOG_VREFINT_PERIOD_SCANS, ANALOG_VREFINT_RATIO, ANALOG_VREFINT_SHIFT, ANALOG_VREFINT_SAMPLING_TIME },
+    { ANALOG_TEMPERATURE_PERIOD_SCANS, ANALOG_TEMPERATURE_RATIO, ANALOG_TEMPERATURE_SHIFT, ANALOG_TEMPERATURE_SAMPLING_TIME }
+};
+
+static const uint8_t ANALOG_BLANKING_PERIODS[ANALOG_OUTPUT_CURRENT_RANGE_LAST] = {
+    0,
+    (ANALOG_BLANKING_RANGE_LOW_US / ANALOG_BLANKING_PERIOD_US),
+    (ANALOG_BLANKING_RANGE_MIDDLE_US / ANALOG_BLANKING_PERIOD_US),
+    (ANALOG_BLANKING_RANGE_HIGH_US / ANALOG_BLANKING_PERIOD_US),
+    0
+};
+
+static const ANALOG_scan_index_t ANALOG_CHANNEL_SCAN_INDEX[ANALOG_CHANNEL_LAST] = {
+    ANALOG_SCAN_INDEX_VREFINT,
+    ANALOG_SCAN_INDEX_TEMPERATURE,
+    ANALOG_SCAN_INDEX_OUTPUT_VOLTAGE,
+    ANALOG_SCAN_INDEX_OUTPUT_CURRENT,
+    ANALOG_SCAN_INDEX_OUTPUT_CURRENT,
+    ANALOG_SCAN_INDEX_OUTPUT_CURRENT,
+    ANALOG_SCAN_INDEX_OUTPUT_VOLTAGE,
+    ANALOG_SCAN_INDEX_OUTPUT_VOLTAGE
+};
+
 static ANALOG_context_t analog_ctx = {
     .flags.all = 0,
     .data = { [0 ... (ANALOG_CHANNEL_LAST - 1)] = 0 },
+    .filtered_data = { [0 ... (ANALOG_CHANNEL_LAST - 1)] = 0 },
     .ref191_data_12bits = ANALOG_ERROR_VALUE,
-    .calibration_next_time_seconds = 0
+    .scan_buffer = { [0 ... ((ANALOG_SCAN_NUMBER_OF_SCANS_PER_BLOCK * ANALOG_SCAN_INDEX_LAST * 2) - 1)] = 0 }
 };
 
 /*** ANALOG local functions ***/
 
+/*******************************************************************/
+static uint32_t _ANALOG_enter_critical(void) {
+    // Local variables.
+    uint32_t primask = 0;
+    // Save interrupt state and mask interrupts.
+    __asm volatile ("mrs %0, primask" : "=r" (primask));
+    __asm volatile ("cpsid i" : : : "memory");
+    return primask;
+}
+
+/*******************************************************************/
+static void _ANALOG_exit_critical(uint32_t primask) {
+    // Restore interrupt state.
+    __asm volatile ("msr primask, %0" : : "r" (primask) : "memory");
+}
+
+/*******************************************************************/
+static uint8_t _ANALOG_is_main_context(void) {
+    // Local variables.
+    uint32_t ipsr = 0;
+    uint32_t primask = 0;
+    // Thread mode with interrupts enabled.
+    __asm volatile ("mrs %0, ipsr" : "=r" (ipsr));
+    __asm volatile ("mrs %0, primask" : "=r" (primask));
+    return (((ipsr == 0) && (primask == 0)) ? 1 : 0);
+}
+
+/*******************************************************************/
+static void _ANALOG_compiler_barrier(void) {
+    // Force the copies of interrupt data to be done between the sequence reads.
+    __asm volatile ("" : : : "memory");
+}
+
+/*******************************************************************/
+static int32_t _ANALOG_cosine(uint32_t phase) {
+    // Local variables.
+    int64_t angle = 0;
+    int64_t angle_square = 0;
+    int64_t term = 0;
+    int64_t result = 0;
+    int8_t sign = 1;
+    uint8_t sine = 0;
+    uint8_t order = 0;
+    // Fold phase to the first eighth of turn.
+    phase &= ((((uint32_t) 0b1) << ANALOG_SPECTRUM_PHASE_BITS) - 1);
+    if (phase > (((uint32_t) 0b1) << (ANALOG_SPECTRUM_PHASE_BITS - 1))) {
+        phase = ((((uint32_t) 0b1) << ANALOG_SPECTRUM_PHASE_BITS) - phase);
+    }
+    if (phase > (((uint32_t) 0b1) << (ANALOG_SPECTRUM_PHASE_BITS - 2))) {
+        phase = ((((uint32_t) 0b1) << (ANALOG_SPECTRUM_PHASE_BITS - 1)) - phase);
+        sign = -1;
+    }
+    if (phase > (((uint32_t) 0b1) << (ANALOG_SPECTRUM_PHASE_BITS - 3))) {
+        phase = ((((uint32_t) 0b1) << (ANALOG_SPECTRUM_PHASE_BITS - 2)) - phase);
+        sine = 1;
+    }
+    // Taylor series of cos or sin (angle below pi/4 so that 5 terms give 30 bits).
+    angle = (int64_t) ((((uint64_t) phase) * ANALOG_SPECTRUM_TWO_PI) >> ANALOG_SPECTRUM_PHASE_BITS);
+    angle_square = ((angle * angle) >> ANALOG_SPECTRUM_FRACTIONAL_BITS);
+    term = (sine != 0) ? angle : (((int64_t) 1) << ANALOG_SPECTRUM_FRACTIONAL_BITS);
+    result = term;
+    for (order = 1; order <= ANALOG_SPECTRUM_SERIES_ORDER; order++) {
+        term = -(((term * angle_square) >> ANALOG_SPECTRUM_FRACTIONAL_BITS) / ((int64_t) (((order << 1) - 1 + sine) * ((order << 1) + sine))));
+        result += term;
+    }
+    return (int32_t) (sign * result);
+}
+
+/*******************************************************************/
+static int32_t _ANALOG_get_data_12bits(ANALOG_scan_index_t scan_index) {
+    // Remove extra resolution bits.
+    return (analog_ctx.oversampling[scan_index].data >> (analog_ctx.oversampling[scan_index].resolution_bits - ANALOG_ADC_RESOLUTION_BITS));
+}
+
+/*******************************************************************/
+static uint16_t _ANALOG_get_output_voltage_data_12bits(int32_t output_voltage_mv) {
+    // Local variables.
+    uint32_t data_12bits = 0;
+    // Clamp voltage to the reciprocal range.
+    if (output_voltage_mv <= 0) goto errors;
+    if (output_voltage_mv > ANALOG_MCU_VOLTAGE_MV_MAX) {
+        output_voltage_mv = ANALOG_MCU_VOLTAGE_MV_MAX;
+    }
+    // Inverse conversion: data = (mV * REF191_data) / (REF191_mV * divider_ratio).
+    data_12bits = ANALOG_MATHS_divide(((uint32_t) output_voltage_mv) * ((uint32_t) analog_ctx.ref191_data_12bits), &(analog_ctx.output_voltage_threshold_reciprocal));
+    if (data_12bits > ANALOG_ADC_FULL_SCALE) {
+        data_12bits = ANALOG_ADC_FULL_SCALE;
+    }
+errors:
+    return ((uint16_t) data_12bits);
+}
+
+/*******************************************************************/
+static void _ANALOG_update_watchdog(void) {
+    // Local variables.
+    ADC_SCAN_status_t adc_scan_status = ADC_SCAN_SUCCESS;
+    ANALOG_alarm_entry_t* alarm_low = &(analog_ctx.alarms[ANALOG_ALARM_OUTPUT_VOLTAGE_LOW]);
+    ANALOG_alarm_entry_t* alarm_high = &(analog_ctx.alarms[ANALOG_ALARM_OUTPUT_VOLTAGE_HIGH]);
+    uint16_t low_threshold = 0;
+    uint16_t high_threshold = ANALOG_ADC_FULL_SCALE;
+    uint32_t primask = 0;
+    uint8_t armed = 0;
+    // Called from main loop and interrupts: compute and write the request atomically so that a newer one is never overwritten.
+    primask = _ANALOG_enter_critical();
+    // Thresholds conversion requires calibration.
+    if (analog_ctx.ref191_data_12bits != ANALOG_ERROR_VALUE) {
+        // Latched alarms are not re-armed until acknowledged.
+        if ((alarm_low->enable != 0) && (alarm_low->latched == 0)) {
+            alarm_low->threshold_data_12bits = _ANALOG_get_output_voltage_data_12bits(alarm_low->threshold);
+            low_threshold = (alarm_low->threshold_data_12bits);
+            armed = 1;
+        }
+        if ((alarm_high->enable != 0) && (alarm_high->latched == 0)) {
+            alarm_high->threshold_data_12bits = _ANALOG_get_output_voltage_data_12bits(alarm_high->threshold);
+            high_threshold = (alarm_high->threshold_data_12bits);
+            armed = 1;
+        }
+    }
+    // Update window.
+    if ((armed != 0) && (low_threshold <= high_threshold)) {
+        adc_scan_status = ADC_SCAN_set_watchdog(ADC_CHANNEL_OUTPUT_VOLTAGE, low_threshold, high_threshold);
+    }
+    else {
+        adc_scan_status = ADC_SCAN_disable_watchdog();
+    }
+    _ANALOG_exit_critical(primask);
+    ADC_SCAN_stack_error(ERROR_BASE_ANALOG + ANALOG_ERROR_BASE_ADC_SCAN);
+}
+
+/*******************************************************************/
+static void _ANALOG_watchdog_irq_callback(uint16_t data) {
+    // Local variables.
+    ANALOG_alarm_entry_t* alarm = &(analog_ctx.alarms[ANALOG_ALARM_OUTPUT_VOLTAGE_LOW]);
+    uint8_t resolution_bits = analog_ctx.oversampling[ANALOG_SCAN_INDEX_OUTPUT_VOLTAGE].resolution_bits;
+    // Identify window side.
+    if ((analog_ctx.alarms[ANALOG_ALARM_OUTPUT_VOLTAGE_HIGH].enable != 0) && (data > analog_ctx.alarms[ANALOG_ALARM_OUTPUT_VOLTAGE_HIGH].threshold_data_12bits)) {
+        alarm = &(analog_ctx.alarms[ANALOG_ALARM_OUTPUT_VOLTAGE_HIGH]);
+    }
+    // Latch event.
+    if ((alarm->latched) == 0) {
+        alarm->timestamp_us = TIMER_get_time_us();
+        alarm->value = (int32_t) ANALOG_MATHS_divide((((uint32_t) data) << (resolution_bits - ANALOG_ADC_RESOLUTION_BITS)) * ANALOG_REF191_VOLTAGE_MV * ((uint32_t) analog_ctx.output_voltage_divider_ratio), &(analog_ctx.output_voltage_reciprocal));
+        alarm->latched = 1;
+        EVENT_post(EVENT_ANALOG_WATCHDOG);
+    }
+    // Keep watching the other side.
+    _ANALOG_update_watchdog();
+}
+
+/*******************************************************************/
+static void _ANALOG_check_output_current_alarm(int32_t output_current_ua) {
+    // Local variables.
+    ANALOG_alarm_entry_t* alarm = &(analog_ctx.alarms[ANALOG_ALARM_OUTPUT_CURRENT_HIGH]);
+    // Check threshold.
+    if (((alarm->enable) == 0) || ((alarm->latched) != 0) || (output_current_ua <= (alarm->threshold))) goto errors;
+    // Latch event.
+    alarm->timestamp_us = analog_ctx.timestamp_us;
+    alarm->value = output_current_ua;
+    alarm->latched = 1;
+    EVENT_post(EVENT_ANALOG_ALARM);
+errors:
+    return;
+}
+
+/*******************************************************************/
+static ANALOG_output_current_range_t _ANALOG_get_output_current_range(void) {
+    // Use the TRCS board state latched by the main loop when the bypass switch is off.
+    return ((analog_ctx.flags.trcs_bypass == 0) ? analog_ctx.trcs_output_current_range : ANALOG_OUTPUT_CURRENT_RANGE_BYPASS);
+}
+
+/*******************************************************************/
+static int32_t _ANALOG_get_output_voltage_divider_current_ua(void) {
+    // Local variables.
+    int32_t output_voltage_divider_current_ua = 0;
+    // Check output voltage.
+    if ((analog_ctx.data[ANALOG_CHANNEL_OUTPUT_VOLTAGE_MV] == ANALOG_ERROR_VALUE) || (analog_ctx.data[ANALOG_CHANNEL_OUTPUT_VOLTAGE_MV] <= 0)) goto errors;
+    // Current drawn by the output voltage divider, which is seen by the TRCS board.
+    output_voltage_divider_current_ua = (int32_t) ANALOG_MATHS_divide((uint32_t) (analog_ctx.data[ANALOG_CHANNEL_OUTPUT_VOLTAGE_MV] * 1000), &(analog_ctx.output_voltage_divider_resistance_reciprocal));
+errors:
+    return output_voltage_divider_current_ua;
+}
+
+/*******************************************************************/
+static void _ANALOG_update_output_current_watchdog(void) {
+    // Local variables.
+    ANALOG_alarm_entry_t* alarm = &(analog_ctx.alarms[ANALOG_ALARM_OUTPUT_CURRENT_HIGH]);
+    uint32_t threshold_ua = 0;
+    uint32_t threshold_data_12bits = 0;
+    uint8_t idx = 0;
+    // Threshold seen by the TRCS board includes the output voltage divider current.
+    if ((alarm->enable != 0) && (alarm->latched == 0)) {
+        threshold_ua = ((uint32_t) (alarm->threshold)) + ((uint32_t) _ANALOG_get_output_voltage_divider_current_ua());
+    }
+    // Convert threshold to raw data of each range (called from main loop only).
+    for (idx = 0; idx < ANALOG_OUTPUT_CURRENT_RANGE_LAST; idx++) {
+        threshold_data_12bits = ANALOG_CURRENT_ALARM_DISARMED;
+        // Ranges without learned gain only rely on the TRCS samples check.
+        if ((threshold_ua != 0) && (threshold_ua <= (0xFFFFFFFF >> ANALOG_CURRENT_GAIN_FRACTIONAL_BITS)) && (analog_ctx.output_current_gain[idx] != 0)) {
+            threshold_data_12bits = ((threshold_ua << ANALOG_CURRENT_GAIN_FRACTIONAL_BITS) / analog_ctx.output_current_gain[idx]);
+            // Threshold above the range full scale can only be detected by the TRCS samples check.
+            if (threshold_data_12bits > ANALOG_ADC_FULL_SCALE) {
+                threshold_data_12bits = ANALOG_CURRENT_ALARM_DISARMED;
+            }
+        }
+        analog_ctx.output_current_threshold_data_12bits[idx] = (uint16_t) threshold_data_12bits;
+    }
+}
+
+/*******************************************************************/
+static void _ANALOG_update_output_current_gain(int32_t output_current_ua, ANALOG_output_current_range_t output_current_range) {
+    // Local variables.
+    int32_t data_12bits = _ANALOG_get_data_12bits(ANALOG_SCAN_INDEX_OUTPUT_CURRENT);
+    int32_t gain = 0;
+    // Learn gain on settled and unsaturated samples which are large enough to be accurate (the TRCS board output is proportional to the current).
+    if ((output_current_range < ANALOG_OUTPUT_CURRENT_RANGE_LOW) || (output_current_range > ANALOG_OUTPUT_CURRENT_RANGE_HIGH)) goto errors;
+    if ((output_current_range != analog_ctx.journal_output_current_range) || (analog_ctx.blanking_count != 0)) goto errors;
+    if ((output_current_ua == ANALOG_ERROR_VALUE) || (output_current_ua <= 0) || (((uint32_t) output_current_ua) > (0x7FFFFFFF >> ANALOG_CURRENT_GAIN_FRACTIONAL_BITS))) goto errors;
+    if ((data_12bits < ANALOG_CURRENT_GAIN_DATA_MIN) || (data_12bits >= ANALOG_ADC_FULL_SCALE)) goto errors;
+    // Compute gain in uA per LSB.
+    gain = ((output_current_ua << ANALOG_CURRENT_GAIN_FRACTIONAL_BITS) / data_12bits);
+    // Filter gain to reject samples taken across a current step.
+    if (analog_ctx.output_current_gain[output_current_range] != 0) {
+        gain = ((int32_t) analog_ctx.output_current_gain[output_current_range]) + ((gain - ((int32_t) analog_ctx.output_current_gain[output_current_range])) >> ANALOG_CURRENT_GAIN_FILTER_SHIFT);
+    }
+    analog_ctx.output_current_gain[output_current_range] = (uint32_t) gain;
+errors:
+    // Follow the output voltage divider current.
+    _ANALOG_update_output_current_watchdog();
+}
+
+/*******************************************************************/
+static void _ANALOG_check_output_current_watchdog(uint16_t* scan) {
+    // Local variables.
+    ANALOG_alarm_entry_t* alarm = &(analog_ctx.alarms[ANALOG_ALARM_OUTPUT_CURRENT_HIGH]);
+    ANALOG_output_current_range_t output_current_range = _ANALOG_get_output_current_range();
+    int32_t output_current_ua = 0;
+    // Ignore range switches which have not been seen by the output current conversion yet, and their settling window.
+    if ((alarm->enable == 0) || (alarm->latched != 0) || (output_current_range != analog_ctx.journal_output_current_range) || (analog_ctx.blanking_count != 0) || (scan[ANALOG_SCAN_INDEX_OUTPUT_CURRENT] <= analog_ctx.output_current_threshold_data_12bits[output_current_range])) {
+        analog_ctx.output_current_alarm_count = 0;
+        goto errors;
+    }
+    // Require consecutive scans above threshold to reject a range switch racing with the main loop latch.
+    analog_ctx.output_current_alarm_count++;
+    if (analog_ctx.output_current_alarm_count < ANALOG_CURRENT_ALARM_SCANS) goto errors;
+    analog_ctx.output_current_alarm_count = 0;
+    // Convert raw data with the learned gain.
+    output_current_ua = (int32_t) ((((uint64_t) scan[ANALOG_SCAN_INDEX_OUTPUT_CURRENT]) * ((uint64_t) analog_ctx.output_current_gain[output_current_range])) >> ANALOG_CURRENT_GAIN_FRACTIONAL_BITS);
+    output_current_ua -= _ANALOG_get_output_voltage_divider_current_ua();
+    // Latch event.
+    alarm->timestamp_us = analog_ctx.timestamp_us;
+    alarm->value = output_current_ua;
+    alarm->latched = 1;
+    EVENT_post(EVENT_ANALOG_ALARM);
+errors:
+    return;
+}
+
+/*******************************************************************/
+static void _ANALOG_alarm_event_handler(void) {
+    // Local variables.
+    ANALOG_alarm_cb_t alarm_callback = NULL;
+    uint8_t alarm = 0;
+    uint8_t idx = 0;
+    // Notify newly latched alarms.
+    for (alarm = 0; alarm < ANALOG_ALARM_LAST; alarm++) {
+        if ((analog_ctx.alarms[alarm].latched == 0) || (analog_ctx.alarms[alarm].notified != 0)) continue;
+        analog_ctx.alarms[alarm].notified = 1;
+        for (idx = 0; idx < ANALOG_ALARM_CALLBACKS_MAX; idx++) {
+            alarm_callback = analog_ctx.alarm_callbacks[idx];
+            if (alarm_callback != NULL) {
+                alarm_callback((ANALOG_alarm_t) alarm);
+            }
+        }
+    }
+}
+
+/*******************************************************************/
+static void _ANALOG_integrate_energy(int32_t output_current_ua, int32_t output_power_uw) {
+    // Accumulate one output current period.
+    analog_ctx.energy.number_of_periods++;
+    analog_ctx.energy.output_charge_ua_periods += (uint64_t) output_current_ua;
+    analog_ctx.energy.output_energy_uw_periods += (uint64_t) output_power_uw;
+    analog_ctx.energy_sequence++;
+}
+
+/*******************************************************************/
+static void _ANALOG_update_quantiles(int32_t output_current_ua) {
+    // Local variables.
+    uint32_t value = (uint32_t) output_current_ua;
+    uint8_t shift = 0;
+    uint16_t bucket = 0;
+    uint16_t idx = 0;
+    // Apply reset request.
+    if (analog_ctx.quantile_reset_request != 0) {
+        analog_ctx.quantile_reset_request = 0;
+        analog_ctx.quantile_number_of_samples = 0;
+        for (idx = 0; idx < ANALOG_QUANTILE_NUMBER_OF_BUCKETS; idx++) {
+            analog_ctx.quantile_histogram[idx] = 0;
+        }
+    }
+    // Clamp value.
+    if (output_current_ua < 0) {
+        value = 0;
+    }
+    if (value > ANALOG_QUANTILE_VALUE_MAX) {
+        value = ANALOG_QUANTILE_VALUE_MAX;
+    }
+    // Compute bucket: octave index followed by the most significant bits after the leading one.
+    if (value >= ANALOG_QUANTILE_SUB_BUCKETS) {
+        shift = (uint8_t) (ANALOG_MATHS_get_bit_length(value) - ANALOG_QUANTILE_SUB_BUCKET_BITS - 1);
+        bucket = (uint16_t) (((shift + 1) << ANALOG_QUANTILE_SUB_BUCKET_BITS) + (value >> shift) - ANALOG_QUANTILE_SUB_BUCKETS);
+    }
+    else {
+        bucket = (uint16_t) value;
+    }
+    // Halve all counts on saturation, which keeps the distribution shape.
+    if (analog_ctx.quantile_histogram[bucket] >= ANALOG_QUANTILE_BUCKET_COUNT_MAX) {
+        for (idx = 0; idx < ANALOG_QUANTILE_NUMBER_OF_BUCKETS; idx++) {
+            analog_ctx.quantile_histogram[idx] >>= 1;
+        }
+    }
+    analog_ctx.quantile_histogram[bucket]++;
+    analog_ctx.quantile_number_of_samples++;
+}
+
+/*******************************************************************/
+static void _ANALOG_read_energy_accumulator(ANALOG_energy_accumulator_t* energy) {
+    // Local variables.
+    uint32_t sequence = 0;
+    // Copy accumulators until they were not updated during the copy.
+    do {
+        sequence = analog_ctx.energy_sequence;
+        _ANALOG_compiler_barrier();
+        (*energy) = analog_ctx.energy;
+        _ANALOG_compiler_barrier();
+    }
+    while (sequence != analog_ctx.energy_sequence);
+}
+
 /*******************************************************************/
 static ANALOG_status_t _ANALOG_convert_channel(ANALOG_channel_t channel) {
     // Local variables.
     ANALOG_status_t status = ANALOG_SUCCESS;
     ADC_status_t adc_status = ADC_SUCCESS;
-    TRCS_status_t trcs_status = TRCS_SUCCESS;
     int32_t adc_data_12bits = 0;
+    int32_t adc_data = 0;
+    int32_t mcu_voltage_mv = 0;
     int32_t analog_data = 0;
     int32_t output_voltage_voltage_divider_current_ua = 0;
+    uint32_t output_voltage_mv = 0;
+    uint32_t output_current_ua = 0;
+    uint64_t output_power_uw = 0;
     // Check channel.
     switch (channel) {
     case ANALOG_CHANNEL_MCU_VOLTAGE_MV:
         // MCU voltage.
-        adc_status = ADC_convert_channel(ADC_CHANNEL_VREFINT, &adc_data_12bits);
-        ADC_exit_error(ANALOG_ERROR_BASE_ADC);
+        adc_data_12bits = _ANALOG_get_data_12bits(ANALOG_SCAN_INDEX_VREFINT);
         // Convert to mV.
         adc_status = ADC_compute_mcu_voltage(adc_data_12bits, ADC_get_vrefint_voltage_mv(), &analog_data);
         ADC_exit_error(ANALOG_ERROR_BASE_ADC);
         break;
     case ANALOG_CHANNEL_MCU_TEMPERATURE_DEGREES:
         // MCU temperature.
-        adc_status = ADC_convert_channel(ADC_CHANNEL_TEMPERATURE_SENSOR, &adc_data_12bits);
-        ADC_exit_error(ANALOG_ERROR_BASE_ADC);
-        // Convert to degrees.
-        adc_status = ADC_compute_mcu_temperature(analog_ctx.data[ANALOG_CHANNEL_MCU_VOLTAGE_MV], adc_data_12bits, &analog_data);
-        ADC_exit_error(ANALOG_ERROR_BASE_ADC);
+        adc_data_12bits = _ANALOG_get_data_12bits(ANALOG_SCAN_INDEX_TEMPERATURE);
+        mcu_voltage_mv = analog_ctx.data[ANALOG_CHANNEL_MCU_VOLTAGE_MV];
+        // Clamp supply voltage to the reciprocal range.
+        if (mcu_voltage_mv < 0) {
+            mcu_voltage_mv = 0;
+        }
+        if (mcu_voltage_mv > ANALOG_MCU_VOLTAGE_MV_MAX) {
+            mcu_voltage_mv = ANALOG_MCU_VOLTAGE_MV_MAX;
+        }
+        // Convert to degrees: T = T1 + (data * VDD - CAL1 * VDDA) / ((VDDA / (T2 - T1)) * (CAL2 - CAL1)).
+        adc_data = (adc_data_12bits * mcu_voltage_mv) - (analog_ctx.ts_cal1_data_scaled);
+        analog_data = ANALOG_MATHS_divide_signed(adc_data, &(analog_ctx.mcu_temperature_reciprocal)) + ANALOG_TS_CAL1_TEMPERATURE_DEGREES;
         break;
     case ANALOG_CHANNEL_OUTPUT_VOLTAGE_MV:
         // Check calibration.
@@ -99,10 +792,9 @@ static ANALOG_status_t _ANALOG_convert_channel(ANALOG_channel_t channel) {
             goto errors;
         }
         // Output voltage.
-        adc_status = ADC_convert_channel(ADC_CHANNEL_OUTPUT_VOLTAGE, &adc_data_12bits);
-        ADC_exit_error(ANALOG_ERROR_BASE_ADC);
+        adc_data = analog_ctx.oversampling[ANALOG_SCAN_INDEX_OUTPUT_VOLTAGE].data;
         // Convert to mV.
-        analog_data = (adc_data_12bits * ANALOG_REF191_VOLTAGE_MV * analog_ctx.output_voltage_divider_ratio) / (analog_ctx.ref191_data_12bits);
+        analog_data = (int32_t) ANALOG_MATHS_divide((uint32_t) (adc_data * ANALOG_REF191_VOLTAGE_MV * analog_ctx.output_voltage_divider_ratio), &(analog_ctx.output_voltage_reciprocal));
         break;
     case ANALOG_CHANNEL_OUTPUT_CURRENT_MV:
         // Check calibration.
@@ -111,19 +803,23 @@ static ANALOG_status_t _ANALOG_convert_channel(ANALOG_channel_t channel) {
             goto errors;
         }
         // Output current.
-        adc_status = ADC_convert_channel(ADC_CHANNEL_OUTPUT_CURRENT, &adc_data_12bits);
-        ADC_exit_error(ANALOG_ERROR_BASE_ADC);
+        adc_data = analog_ctx.oversampling[ANALOG_SCAN_INDEX_OUTPUT_CURRENT].data;
         // Convert to mV.
-        analog_data = (adc_data_12bits * ANALOG_REF191_VOLTAGE_MV) / (analog_ctx.ref191_data_12bits);
+        analog_data = (int32_t) ANALOG_MATHS_divide((uint32_t) (adc_data * ANALOG_REF191_VOLTAGE_MV), &(analog_ctx.output_current_reciprocal));
         break;
     case ANALOG_CHANNEL_OUTPUT_CURRENT_UA:
         // Check bypass switch.
         if (analog_ctx.flags.trcs_bypass == 0) {
-            // Read from TRCS board.
-            trcs_status = TRCS_get_output_current(&analog_data);
-            TRCS_exit_error(ANALOG_ERROR_BASE_TRCS);
+            // Hold last value until the TRCS board provides a new sample (latched by the main loop at the TRCS sampling period).
+            analog_data = analog_ctx.data[ANALOG_CHANNEL_OUTPUT_CURRENT_UA];
+            if (analog_ctx.trcs_sample_update == 0) break;
+            // Consume sample: output current is valid again once a sample latched after the last range switch is converted.
+            analog_ctx.trcs_converted_sequence = analog_ctx.trcs_sequence;
+            analog_ctx.output_current_valid = 1;
+            analog_data = analog_ctx.trcs_output_current_ua;
+            if (analog_data == ANALOG_ERROR_VALUE) break;
             // Compute output voltage divider current.
-            output_voltage_voltage_divider_current_ua = (analog_ctx.data[ANALOG_CHANNEL_OUTPUT_VOLTAGE_MV] * 1000) / (analog_ctx.output_voltage_divider_resistance_ohms);
+            output_voltage_voltage_divider_current_ua = _ANALOG_get_output_voltage_divider_current_ua();
             // Remove offset current.
             if (analog_data > output_voltage_voltage_divider_current_ua) {
                 analog_data -= output_voltage_voltage_divider_current_ua;
@@ -131,11 +827,57 @@ static ANALOG_status_t _ANALOG_convert_channel(ANALOG_channel_t channel) {
             else {
                 analog_data = 0;
             }
+            _ANALOG_check_output_current_alarm(analog_data);
+            _ANALOG_update_quantiles(analog_data);
+        }
+        else {
+            analog_data = ANALOG_ERROR_VALUE;
+            analog_ctx.output_current_valid = 1;
+        }
+        break;
+    case ANALOG_CHANNEL_OUTPUT_POWER_UW:
+        // Check bypass switch.
+        if (analog_ctx.flags.trcs_bypass == 0) {
+            // Output voltage averaged on the same scans as the output current.
+            output_voltage_mv = ANALOG_MATHS_divide((analog_ctx.output_voltage_aligned_raw_sum * ANALOG_REF191_VOLTAGE_MV * ((uint32_t) analog_ctx.output_voltage_divider_ratio)), &(analog_ctx.output_voltage_aligned_reciprocal));
+            // Output current is converted (or held) just before.
+            if (analog_ctx.data[ANALOG_CHANNEL_OUTPUT_CURRENT_UA] == ANALOG_ERROR_VALUE) {
+                analog_data = ANALOG_ERROR_VALUE;
+                break;
+            }
+            output_current_ua = (uint32_t) analog_ctx.data[ANALOG_CHANNEL_OUTPUT_CURRENT_UA];
+            if (output_current_ua > ANALOG_OUTPUT_POWER_CURRENT_UA_MAX) {
+                output_current_ua = ANALOG_OUTPUT_POWER_CURRENT_UA_MAX;
+            }
+            // Convert to uW.
+            output_power_uw = ((((uint64_t) output_voltage_mv) * ((uint64_t) output_current_ua) * ANALOG_OUTPUT_POWER_MULTIPLIER) >> ANALOG_OUTPUT_POWER_SHIFT);
+            // Saturate above 2.1kW (without reaching the error value).
+            if (output_power_uw > ANALOG_OUTPUT_POWER_UW_MAX) {
+                output_power_uw = ANALOG_OUTPUT_POWER_UW_MAX;
+            }
+            analog_data = (int32_t) output_power_uw;
+            _ANALOG_integrate_energy((int32_t) output_current_ua, analog_data);
         }
         else {
             analog_data = ANALOG_ERROR_VALUE;
         }
         break;
+    case ANALOG_CHANNEL_OUTPUT_RIPPLE_PEAK_TO_PEAK_MV:
+    case ANALOG_CHANNEL_OUTPUT_RIPPLE_RMS_MV:
+        // Check calibration.
+        if (analog_ctx.ref191_data_12bits == ANALOG_ERROR_VALUE) {
+            status = ANALOG_ERROR_CALIBRATION_MISSING;
+            goto errors;
+        }
+        // Last burst result (already scaled to the output voltage resolution).
+        adc_data = (channel == ANALOG_CHANNEL_OUTPUT_RIPPLE_RMS_MV) ? analog_ctx.ripple.rms_data : analog_ctx.ripple.peak_to_peak_data;
+        if (adc_data == ANALOG_ERROR_VALUE) {
+            analog_data = ANALOG_ERROR_VALUE;
+            break;
+        }
+        // Convert to mV.
+        analog_data = (int32_t) ANALOG_MATHS_divide((uint32_t) (adc_data * ANALOG_REF191_VOLTAGE_MV * analog_ctx.output_voltage_divider_ratio), &(analog_ctx.output_voltage_reciprocal));
+        break;
     default:
         status = ANALOG_ERROR_CHANNEL;
         goto errors;
@@ -147,62 +889,751 @@ errors:
 }
 
 /*******************************************************************/
-static void _ANALOG_timer_irq_callback(void) {
+static int32_t _ANALOG_filter_channel(ANALOG_channel_t channel, int32_t analog_data) {
     // Local variables.
-    ANALOG_status_t analog_status = ANALOG_SUCCESS;
+    ANALOG_filter_t* filter = &(analog_ctx.filter[channel]);
+    int32_t window[ANALOG_FILTER_MEDIAN_TAPS_MAX];
+    int32_t median = analog_data;
+    int32_t output = 0;
+    int32_t deviation = 0;
+    int32_t swap = 0;
+    uint8_t number_of_taps = 0;
     uint8_t idx = 0;
-    // Convert all channels.
-    for (idx = 0; idx < ANALOG_CHANNEL_LAST; idx++) {
-        analog_status = _ANALOG_convert_channel(idx);
-        ANALOG_stack_error(ERROR_BASE_ANALOG);
+    uint8_t jdx = 0;
+    // Check filter and data.
+    if ((filter->enable) == 0) goto errors;
+    if (analog_data == ANALOG_ERROR_VALUE) {
+        // Restart filter on next valid data.
+        filter->history_count = 0;
+        goto errors;
     }
+    // Store sample.
+    filter->history[filter->history_index] = analog_data;
+    filter->history_index = (uint8_t) (((filter->history_index) + 1) % ANALOG_FILTER_MEDIAN_TAPS_MAX);
+    if ((filter->history_count) < ANALOG_FILTER_MEDIAN_TAPS_MAX) {
+        filter->history_count++;
+    }
+    // Median of the last samples (insertion sort of at most 5 values).
+    number_of_taps = ((filter->history_count) < (filter->median_taps)) ? (filter->history_count) : (filter->median_taps);
+    for (idx = 0; idx < number_of_taps; idx++) {
+        swap = filter->history[((filter->history_index) + ANALOG_FILTER_MEDIAN_TAPS_MAX - 1 - idx) % ANALOG_FILTER_MEDIAN_TAPS_MAX];
+        for (jdx = idx; (jdx > 0) && (window[jdx - 1] > swap); jdx--) {
+            window[jdx] = window[jdx - 1];
+        }
+        window[jdx] = swap;
+    }
+    median = window[number_of_taps >> 1];
+    // Fast settle on first sample or step.
+    output = (int32_t) ((filter->output) >> ANALOG_FILTER_FRACTIONAL_BITS);
+    deviation = (median > output) ? (median - output) : (output - median);
+    if (((filter->history_count) == 1) || (((filter->step_threshold) > 0) && (deviation > (filter->step_threshold)))) {
+        filter->output = (((int64_t) median) << ANALOG_FILTER_FRACTIONAL_BITS);
+    }
+    else if ((filter->alpha) != 0) {
+        // First order low pass: y += alpha * (x - y).
+        filter->output += (((((int64_t) median) << ANALOG_FILTER_FRACTIONAL_BITS) - (filter->output)) * ((int64_t) filter->alpha)) >> ANALOG_FILTER_ALPHA_BITS;
+    }
+    else {
+        filter->output = (((int64_t) median) << ANALOG_FILTER_FRACTIONAL_BITS);
+    }
+    analog_data = (int32_t) (((filter->output) + (0b1 << (ANALOG_FILTER_FRACTIONAL_BITS - 1))) >> ANALOG_FILTER_FRACTIONAL_BITS);
+errors:
+    return analog_data;
 }
 
 /*******************************************************************/
-static void _ANALOG_trcs_process_callback(void) {
+static void _ANALOG_latch_trcs_sample(int32_t output_current_ua, ANALOG_output_current_range_t output_current_range) {
     // Local variables.
-    TRCS_status_t trcs_status = TRCS_SUCCESS;
-    // Process TRCS board.
-    trcs_status = TRCS_process();
-    TRCS_stack_error(ERROR_BASE_ANALOG + ANALOG_ERROR_BASE_TRCS);
+    uint32_t primask = 0;
+    // Publish sample and range together to the ADC interrupt.
+    primask = _ANALOG_enter_critical();
+    analog_ctx.trcs_output_current_ua = output_current_ua;
+    analog_ctx.trcs_output_current_range = output_current_range;
+    analog_ctx.trcs_sequence++;
+    _ANALOG_exit_critical(primask);
 }
 
 /*******************************************************************/
-static ANALOG_status_t _ANALOG_calibrate(void) {
+static void _ANALOG_record_journal(ANALOG_journal_event_t event) {
     // Local variables.
-    ANALOG_status_t status = ANALOG_SUCCESS;
-    ADC_status_t adc_status = ADC_SUCCESS;
-    int32_t adc_data_12bits = 0;
-    // Convert external voltage reference.
-    adc_status = ADC_convert_channel(ADC_CHANNEL_REF191, &adc_data_12bits);
-    ADC_exit_error(ANALOG_ERROR_BASE_ADC);
-    // Update local calibration value.
-    analog_ctx.ref191_data_12bits = adc_data_12bits;
+    ANALOG_journal_record_t* record = &(analog_ctx.journal[analog_ctx.journal_sequence & ANALOG_JOURNAL_INDEX_MASK]);
+    // Overwrite oldest record.
+    record->timestamp_us = analog_ctx.timestamp_us;
+    record->output_current_ua = analog_ctx.journal_output_current_ua;
+    record->event = (uint8_t) event;
+    record->output_current_range = (uint8_t) analog_ctx.journal_output_current_range;
+    // Publish record.
+    analog_ctx.journal_sequence++;
+}
+
+/*******************************************************************/
+static uint8_t _ANALOG_is_blanked(ANALOG_channel_t channel) {
+    // Output current derived channels are not valid during the settling window.
+    return (((analog_ctx.blanking_count != 0) && (((ANALOG_BLANKING_CHANNEL_MASK >> channel) & 0b1) != 0)) ? 1 : 0);
+}
+
+/*******************************************************************/
+static void _ANALOG_update_output_current_range(void) {
+    // Local variables.
+    ANALOG_flags_t flags;
+    ANALOG_output_current_range_t previous_output_current_range = analog_ctx.journal_output_current_range;
+    // Update last valid output current (converted on previous period).
+    if (analog_ctx.data[ANALOG_CHANNEL_OUTPUT_CURRENT_UA] != ANALOG_ERROR_VALUE) {
+        analog_ctx.journal_output_current_ua = analog_ctx.data[ANALOG_CHANNEL_OUTPUT_CURRENT_UA];
+    }
+    // Check if the TRCS board provided a sample which has not been converted yet (it stays pending during the settling window).
+    analog_ctx.trcs_sample_update = (analog_ctx.trcs_sequence != analog_ctx.trcs_converted_sequence) ? 1 : 0;
+    // Count down settling window.
+    if (analog_ctx.blanking_count != 0) {
+        analog_ctx.blanking_count--;
+    }
+    // Read current state.
+    flags.all = analog_ctx.flags.all;
+    analog_ctx.journal_output_current_range = _ANALOG_get_output_current_range();
+    // Record bypass switch and TRCS board transitions (several of them can happen during the same period).
+    if (flags.trcs_bypass != analog_ctx.journal_flags.trcs_bypass) {
+        _ANALOG_record_journal((flags.trcs_bypass != 0) ? ANALOG_JOURNAL_EVENT_BYPASS_ON : ANALOG_JOURNAL_EVENT_BYPASS_OFF);
+    }
+    if (flags.trcs_started != analog_ctx.journal_flags.trcs_started) {
+        _ANALOG_record_journal((flags.trcs_started != 0) ? ANALOG_JOURNAL_EVENT_TRCS_START : ANALOG_JOURNAL_EVENT_TRCS_STOP);
+    }
+    if (analog_ctx.journal_output_current_range != previous_output_current_range) {
+        // Range switch with the output current which triggered it.
+        _ANALOG_record_journal(ANALOG_JOURNAL_EVENT_OUTPUT_CURRENT_RANGE);
+    }
+    analog_ctx.journal_flags.all = flags.all;
+    // Start settling window of the new range, held data is invalid until the next conversion.
+    if (analog_ctx.journal_output_current_range != previous_output_current_range) {
+        analog_ctx.blanking_count = ANALOG_BLANKING_PERIODS[analog_ctx.journal_output_current_range];
+        analog_ctx.output_current_valid = 0;
+    }
+}
+
+/*******************************************************************/
+static void _ANALOG_calibrate(void) {
+    // Local variables.
+    uint32_t ref191_average = analog_ctx.ref191_average;
+    uint8_t resolution_bits = 0;
+    uint32_t dividend_max = 0;
+    uint32_t output_voltage_mv_max = 0;
+    // Check data.
+    if ((ref191_average >> ANALOG_CALIBRATION_FRACTIONAL_BITS) == 0) goto errors;
+    // Output voltage reciprocal with averaged reference scaled to the same resolution.
+    resolution_bits = analog_ctx.oversampling[ANALOG_SCAN_INDEX_OUTPUT_VOLTAGE].resolution_bits;
+    dividend_max = ((((uint32_t) 0b1) << resolution_bits) - 1) * ANALOG_REF191_VOLTAGE_MV * ((uint32_t) analog_ctx.output_voltage_divider_ratio);
+    ANALOG_MATHS_compute_reciprocal((ref191_average >> (ANALOG_CALIBRATION_FRACTIONAL_BITS + ANALOG_ADC_RESOLUTION_BITS - resolution_bits)), dividend_max, &(analog_ctx.output_voltage_reciprocal));
+    // Output voltage reciprocal for the sum of the samples aligned on the output current ones.
+    ANALOG_MATHS_compute_reciprocal(((ref191_average * ANALOG_OUTPUT_CURRENT_RATIO) >> ANALOG_CALIBRATION_FRACTIONAL_BITS), (ANALOG_ADC_FULL_SCALE * ANALOG_OUTPUT_CURRENT_RATIO * ANALOG_REF191_VOLTAGE_MV * ((uint32_t) analog_ctx.output_voltage_divider_ratio)), &(analog_ctx.output_voltage_aligned_reciprocal));
+    // Output voltage divider resistance reciprocal.
+    output_voltage_mv_max = ANALOG_MATHS_divide(dividend_max, &(analog_ctx.output_voltage_reciprocal));
+    ANALOG_MATHS_compute_reciprocal((uint32_t) analog_ctx.output_voltage_divider_resistance_ohms, (output_voltage_mv_max * 1000), &(analog_ctx.output_voltage_divider_resistance_reciprocal));
+    // Output current reciprocal with reference scaled to the same resolution.
+    resolution_bits = analog_ctx.oversampling[ANALOG_SCAN_INDEX_OUTPUT_CURRENT].resolution_bits;
+    dividend_max = ((((uint32_t) 0b1) << resolution_bits) - 1) * ANALOG_REF191_VOLTAGE_MV;
+    ANALOG_MATHS_compute_reciprocal((ref191_average >> (ANALOG_CALIBRATION_FRACTIONAL_BITS + ANALOG_ADC_RESOLUTION_BITS - resolution_bits)), dividend_max, &(analog_ctx.output_current_reciprocal));
+    // Update local calibration value from the external voltage reference data.
+    analog_ctx.ref191_data_12bits = (int32_t) ((ref191_average + (0b1 << (ANALOG_CALIBRATION_FRACTIONAL_BITS - 1))) >> ANALOG_CALIBRATION_FRACTIONAL_BITS);
+    // Update watchdog thresholds with the new calibration.
+    _ANALOG_update_watchdog();
+    _ANALOG_record_journal(ANALOG_JOURNAL_EVENT_CALIBRATION);
 errors:
-    return status;
+    return;
 }
 
-/*** ANALOG functions ***/
+/*******************************************************************/
+static void _ANALOG_update_calibration(void) {
+    // Local variables.
+    uint32_t ref191_data = 0;
+    uint32_t deviation = 0;
+    uint32_t applied_data = 0;
+    int32_t vrefint_data_12bits = _ANALOG_get_data_12bits(ANALOG_SCAN_INDEX_VREFINT);
+    int32_t temperature_degrees = analog_ctx.data[ANALOG_CHANNEL_MCU_TEMPERATURE_DEGREES];
+    uint8_t shift = ANALOG_CALIBRATION_SLOW_SHIFT;
+    // Reference conversion with the oversampling bits kept as fractional part (ratio equals 2^shift).
+    ref191_data = (analog_ctx.oversampling[ANALOG_SCAN_INDEX_REF191].raw_sum << (ANALOG_CALIBRATION_FRACTIONAL_BITS - ANALOG_REF191_SHIFT));
+    if ((ref191_data >> ANALOG_CALIBRATION_FRACTIONAL_BITS) == 0) goto errors;
+    // Seed average on first conversion.
+    if (analog_ctx.ref191_data_12bits == ANALOG_ERROR_VALUE) {
+        analog_ctx.ref191_average = ref191_data;
+        analog_ctx.calibration_outlier_count = 0;
+        analog_ctx.calibration_vrefint_data_12bits = vrefint_data_12bits;
+        analog_ctx.calibration_temperature_degrees = temperature_degrees;
+    }
+    else {
+        // Reject isolated outliers, but follow a persistent step (supply change).
+        deviation = (ref191_data > analog_ctx.ref191_average) ? (ref191_data - analog_ctx.ref191_average) : (analog_ctx.ref191_average - ref191_data);
+        if (deviation > ANALOG_CALIBRATION_OUTLIER_THRESHOLD) {
+            analog_ctx.calibration_outlier_count++;
+            if ((analog_ctx.calibration_outlier_count) < ANALOG_CALIBRATION_OUTLIER_COUNT_MAX) goto errors;
+            analog_ctx.ref191_average = ref191_data;
+        }
+        analog_ctx.calibration_outlier_count = 0;
+        // Faster refresh when supply voltage or temperature drift.
+        deviation = (uint32_t) ((vrefint_data_12bits > analog_ctx.calibration_vrefint_data_12bits) ? (vrefint_data_12bits - analog_ctx.calibration_vrefint_data_12bits) : (analog_ctx.calibration_vrefint_data_12bits - vrefint_data_12bits));
+        if (deviation > ANALOG_CALIBRATION_VREFINT_DRIFT) {
+            analog_ctx.calibration_fast_count = ANALOG_CALIBRATION_FAST_CONVERSIONS;
+        }
+        deviation = (uint32_t) ((temperature_degrees > analog_ctx.calibration_temperature_degrees) ? (temperature_degrees - analog_ctx.calibration_temperature_degrees) : (analog_ctx.calibration_temperature_degrees - temperature_degrees));
+        if (deviation > ANALOG_CALIBRATION_TEMPERATURE_DRIFT) {
+            analog_ctx.calibration_fast_count = ANALOG_CALIBRATION_FAST_CONVERSIONS;
+        }
+        if ((analog_ctx.calibration_fast_count) != 0) {
+            analog_ctx.calibration_fast_count--;
+            analog_ctx.calibration_vrefint_data_12bits = vrefint_data_12bits;
+            analog_ctx.calibration_temperature_degrees = temperature_degrees;
+            shift = ANALOG_CALIBRATION_FAST_SHIFT;
+        }
+        // Exponential average.
+        if (ref191_data >= analog_ctx.ref191_average) {
+            analog_ctx.ref191_average += ((ref191_data - analog_ctx.ref191_average) >> shift);
+        }
+        else {
+            analog_ctx.ref191_average -= ((analog_ctx.ref191_average - ref191_data) >> shift);
+        }
+    }
+    // Update reciprocals only when the reference changes at the output voltage resolution.
+    applied_data = (analog_ctx.ref191_average >> (ANALOG_CALIBRATION_FRACTIONAL_BITS + ANALOG_ADC_RESOLUTION_BITS - analog_ctx.oversampling[ANALOG_SCAN_INDEX_OUTPUT_VOLTAGE].resolution_bits));
+    if ((analog_ctx.ref191_data_12bits != ANALOG_ERROR_VALUE) && (applied_data == analog_ctx.ref191_applied_data)) goto errors;
+    analog_ctx.ref191_applied_data = applied_data;
+    _ANALOG_calibrate();
+errors:
+    return;
+}
 
 /*******************************************************************/
-ANALOG_status_t ANALOG_init(void) {
+static void _ANALOG_publish_snapshot(void) {
     // Local variables.
-    ANALOG_status_t status = ANALOG_SUCCESS;
-    NVM_status_t nvm_status = NVM_SUCCESS;
-    ADC_status_t adc_status = ADC_SUCCESS;
-    TIM_status_t tim_status = TIM_SUCCESS;
-    TRCS_status_t trcs_status = TRCS_SUCCESS;
-    uint8_t board_number = 0;
+    volatile ANALOG_snapshot_t* snapshot = NULL;
+    uint32_t sequence = (analog_ctx.snapshot_sequence + 1);
     uint8_t idx = 0;
-    // Init context.
-    analog_ctx.output_voltage_divider_ratio = 0;
-    analog_ctx.output_voltage_divider_resistance_ohms = 1;
-    analog_ctx.flags.all = 0;
+    // Fill the buffer which is not published.
+    snapshot = &(analog_ctx.snapshot[sequence & 0x01]);
+    snapshot->sequence = sequence;
+    snapshot->timestamp_us = analog_ctx.timestamp_us;
+    for (idx = 0; idx < ANALOG_CHANNEL_LAST; idx++) {
+        snapshot->data[idx] = analog_ctx.data[idx];
+        snapshot->filtered_data[idx] = analog_ctx.filtered_data[idx];
+    }
+    snapshot->bypass_switch_state = analog_ctx.flags.trcs_bypass;
+    snapshot->output_current_range = _ANALOG_get_output_current_range();
+    snapshot->output_current_valid = ((analog_ctx.blanking_count == 0) && (analog_ctx.output_current_valid != 0)) ? 1 : 0;
+    // Publish buffer.
+    analog_ctx.snapshot_sequence = sequence;
+}
+
+/*******************************************************************/
+static void _ANALOG_notify(ANALOG_scan_index_t scan_index) {
+    // Local variables.
+    ANALOG_subscription_t* subscription = NULL;
+    ANALOG_data_ready_cb_t data_ready_callback = NULL;
+    ANALOG_channel_t channel = 0;
+    int64_t sum = 0;
+    uint32_t number_of_samples = 0;
+    uint8_t idx = 0;
+    // Subscriptions loop.
+    for (idx = 0; idx < ANALOG_SUBSCRIPTIONS_MAX; idx++) {
+        subscription = &(analog_ctx.subscriptions[idx]);
+        data_ready_callback = (subscription->data_ready_callback);
+        channel = (subscription->channel);
+        // Check if the subscribed channel has been converted.
+        if ((data_ready_callback == NULL) || (ANALOG_CHANNEL_SCAN_INDEX[channel] != scan_index)) continue;
+        // Start averaging window on first conversion.
+        if ((subscription->origin_valid) == 0) {
+            subscription->integrator_origin = analog_ctx.integrator[channel];
+            subscription->number_of_samples_origin = analog_ctx.integrator_number_of_samples[channel];
+            subscription->origin_valid = 1;
+            continue;
+        }
+        // Apply decimation.
+        subscription->count++;
+        if ((subscription->count) >= (subscription->decimation)) {
+            subscription->count = 0;
+            // Boxcar sum from the channel integrator difference (the division is left to the subscriber main context).
+            sum = (analog_ctx.integrator[channel] - (subscription->integrator_origin));
+            number_of_samples = (analog_ctx.integrator_number_of_samples[channel] - (subscription->number_of_samples_origin));
+            subscription->integrator_origin = analog_ctx.integrator[channel];
+            subscription->number_of_samples_origin = analog_ctx.integrator_number_of_samples[channel];
+            data_ready_callback(channel, sum, number_of_samples);
+        }
+    }
+}
+
+/*******************************************************************/
+static void _ANALOG_update_statistics(ANALOG_scan_index_t scan_index) {
+    // Local variables.
+    ANALOG_statistics_slot_t* slot = NULL;
+    ANALOG_statistics_window_t* window = NULL;
+    int32_t analog_data = 0;
+    int32_t deviation = 0;
+    uint32_t deviation_magnitude = 0;
+    uint8_t idx = 0;
+    // Statistics loop.
+    for (idx = 0; idx < ANALOG_STATISTICS_MAX; idx++) {
+        slot = &(analog_ctx.statistics[idx]);
+        // Check if the channel has been converted.
+        if (((slot->enable) == 0) || (ANALOG_CHANNEL_SCAN_INDEX[slot->channel] != scan_index)) continue;
+        if (_ANALOG_is_blanked(slot->channel) != 0) continue;
+        analog_data = analog_ctx.data[slot->channel];
+        if (analog_data == ANALOG_ERROR_VALUE) continue;
+        window = &(slot->window[slot->active_window]);
+        // Start window on first sample.
+        if ((window->number_of_samples) == 0) {
+            window->start_time_us = analog_ctx.timestamp_us;
+            window->min = analog_data;
+            window->max = analog_data;
+            window->offset = analog_data;
+            window->sum = 0;
+            window->sum_of_squares = 0;
+            window->square_shift = 0;
+        }
+        // Accumulate deviation from the first sample to keep the sum of squares small.
+        deviation = (analog_data - (window->offset));
+        window->number_of_samples++;
+        window->sum += (int64_t) deviation;
+        // Scale deviation so that its square fits 32 bits and the sum of squares cannot overflow for any number of samples (power channel deviations reach 2^31).
+        deviation_magnitude = (uint32_t) ((deviation < 0) ? (-deviation) : deviation);
+        while ((deviation_magnitude >> (window->square_shift)) > ANALOG_STATISTICS_DEVIATION_MAX) {
+            window->square_shift++;
+            window->sum_of_squares >>= 2;
+        }
+        deviation_magnitude >>= (window->square_shift);
+        window->sum_of_squares += (uint64_t) (deviation_magnitude * deviation_magnitude);
+        if (analog_data < (window->min)) {
+            window->min = analog_data;
+        }
+        if (analog_data > (window->max)) {
+            window->max = analog_data;
+        }
+    }
+    analog_ctx.statistics_sequence++;
+}
+
+/*******************************************************************/
+static void _ANALOG_process_input(ANALOG_scan_index_t scan_index) {
+    // Local variables.
+    ANALOG_status_t analog_status = ANALOG_SUCCESS;
+    uint8_t idx = 0;
+    // Check input.
+    if (scan_index == ANALOG_SCAN_INDEX_REF191) {
+        // Fold reference conversion into the background calibration.
+        _ANALOG_update_calibration();
+    }
+    else {
+        // Output channels are not converted until the first calibration.
+        if ((scan_index <= ANALOG_SCAN_INDEX_OUTPUT_VOLTAGE) && (analog_ctx.ref191_data_12bits == ANALOG_ERROR_VALUE)) goto errors;
+        // Record range and bypass transitions, and check settling window before converting output current.
+        if (scan_index == ANALOG_SCAN_INDEX_OUTPUT_CURRENT) {
+            _ANALOG_update_output_current_range();
+        }
+        // Convert all channels using this input.
+        for (idx = 0; idx < ANALOG_CHANNEL_LAST; idx++) {
+            if (ANALOG_CHANNEL_SCAN_INDEX[idx] != scan_index) continue;
+            // Hold last valid data during the settling window (energy keeps being integrated with it).
+            if (_ANALOG_is_blanked(idx) != 0) {
+                if ((idx == ANALOG_CHANNEL_OUTPUT_POWER_UW) && (analog_ctx.data[ANALOG_CHANNEL_OUTPUT_CURRENT_UA] != ANALOG_ERROR_VALUE) && (analog_ctx.data[ANALOG_CHANNEL_OUTPUT_POWER_UW] != ANALOG_ERROR_VALUE)) {
+                    _ANALOG_integrate_energy(analog_ctx.data[ANALOG_CHANNEL_OUTPUT_CURRENT_UA], analog_ctx.data[ANALOG_CHANNEL_OUTPUT_POWER_UW]);
+                }
+                continue;
+            }
+            analog_status = _ANALOG_convert_channel(idx);
+            ANALOG_stack_error(ERROR_BASE_ANALOG);
+            analog_ctx.filtered_data[idx] = _ANALOG_filter_channel(idx, analog_ctx.data[idx]);
+            // Integrate valid data for decimated outputs (fixed cost whatever the number of subscribers).
+            if (analog_ctx.data[idx] != ANALOG_ERROR_VALUE) {
+                analog_ctx.integrator[idx] += (int64_t) analog_ctx.data[idx];
+                analog_ctx.integrator_number_of_samples[idx]++;
+            }
+        }
+        // Update statistics and snapshot, then notify subscribers.
+        _ANALOG_update_statistics(scan_index);
+        _ANALOG_publish_snapshot();
+        _ANALOG_notify(scan_index);
+    }
+errors:
+    return;
+}
+
+/*******************************************************************/
+static void _ANALOG_capture(uint16_t* scan) {
+    // Local variables.
+    ANALOG_capture_t* capture = &(analog_ctx.capture);
+    uint16_t output_current_data_12bits = 0;
+    uint16_t previous_output_current_data_12bits = 0;
+    uint8_t trigger = 0;
+    // Check state.
+    if ((capture->state != ANALOG_CAPTURE_STATE_ARMED) && (capture->state != ANALOG_CAPTURE_STATE_TRIGGERED)) goto errors;
+    // Store sample.
+    output_current_data_12bits = scan[ANALOG_SCAN_INDEX_OUTPUT_CURRENT];
+    capture->buffer[capture->write_index].output_voltage_data_12bits = scan[ANALOG_SCAN_INDEX_OUTPUT_VOLTAGE];
+    capture->buffer[capture->write_index].output_current_data_12bits = output_current_data_12bits;
+    capture->write_index = ((capture->write_index + 1) & (ANALOG_CAPTURE_DEPTH - 1));
+    if ((capture->sample_count) < ANALOG_CAPTURE_DEPTH) {
+        capture->sample_count++;
+    }
+    if (capture->state == ANALOG_CAPTURE_STATE_ARMED) {
+        // Wait for pre-trigger samples.
+        if ((capture->sample_count) <= (capture->pre_trigger_samples)) goto errors;
+        // Check trigger condition.
+        switch (capture->trigger) {
+        case ANALOG_CAPTURE_TRIGGER_CURRENT_STEP:
+            previous_output_current_data_12bits = capture->buffer[(capture->write_index - 1 - ANALOG_CAPTURE_STEP_DELAY_SCANS) & (ANALOG_CAPTURE_DEPTH - 1)].output_current_data_12bits;
+            if (output_current_data_12bits > previous_output_current_data_12bits) {
+                trigger = ((output_current_data_12bits - previous_output_current_data_12bits) >= (capture->threshold_data_12bits)) ? 1 : 0;
+            }
+            else {
+                trigger = ((previous_output_current_data_12bits - output_current_data_12bits) >= (capture->threshold_data_12bits)) ? 1 : 0;
+            }
+            break;
+        case ANALOG_CAPTURE_TRIGGER_VOLTAGE_DROOP:
+            trigger = (scan[ANALOG_SCAN_INDEX_OUTPUT_VOLTAGE] < (capture->threshold_data_12bits)) ? 1 : 0;
+            break;
+        default:
+            break;
+        }
+        if (trigger == 0) goto errors;
+        capture->state = ANALOG_CAPTURE_STATE_TRIGGERED;
+    }
+    // Record post-trigger samples (including the trigger one).
+    capture->post_trigger_count++;
+    if ((capture->post_trigger_count) >= (ANALOG_CAPTURE_DEPTH - capture->pre_trigger_samples)) {
+        capture->state = ANALOG_CAPTURE_STATE_COMPLETE;
+    }
+errors:
+    return;
+}
+
+/*******************************************************************/
+static void _ANALOG_update_spectrum(int32_t deviation, uint8_t extra_bits) {
+    // Local variables.
+    ANALOG_spectrum_bin_t* bin = NULL;
+    int32_t s0 = 0;
+    int64_t power = 0;
+    uint32_t amplitude_data = 0;
+    uint8_t idx = 0;
+    // Bins loop.
+    for (idx = 0; idx < ANALOG_SPECTRUM_NUMBER_OF_BINS; idx++) {
+        bin = &(analog_ctx.spectrum[idx]);
+        // Bins configured during a burst wait for the next one.
+        if ((bin->enable) == 0) {
+            bin->active = 0;
+            continue;
+        }
+        if ((analog_ctx.ripple.scan_count) == (ANALOG_RIPPLE_PERIOD_SCANS - ANALOG_RIPPLE_BURST_SCANS + 1)) {
+            bin->active = 1;
+            bin->s1 = 0;
+            bin->s2 = 0;
+        }
+        if ((bin->active) == 0) continue;
+        // Goertzel iteration: s0 = x + 2cos(w) * s1 - s2.
+        s0 = deviation + ((int32_t) ((((int64_t) bin->coefficient) * ((int64_t) bin->s1)) >> ANALOG_SPECTRUM_COEFFICIENT_BITS)) - (bin->s2);
+        bin->s2 = bin->s1;
+        bin->s1 = s0;
+        // Check end of burst.
+        if ((analog_ctx.ripple.scan_count) < ANALOG_RIPPLE_PERIOD_SCANS) continue;
+        // Squared magnitude: s1^2 + s2^2 - 2cos(w) * s1 * s2.
+        power = (((int64_t) bin->s1) * ((int64_t) bin->s1)) + (((int64_t) bin->s2) * ((int64_t) bin->s2)) - (((((int64_t) bin->coefficient) * ((int64_t) bin->s1)) >> ANALOG_SPECTRUM_COEFFICIENT_BITS) * ((int64_t) bin->s2));
+        if (power < 0) {
+            power = 0;
+        }
+        // Peak amplitude = 2 * magnitude / N, at the output voltage resolution.
+        amplitude_data = ((ANALOG_MATHS_sqrt((uint64_t) power) << (extra_bits + 1)) >> ANALOG_RIPPLE_BURST_SCANS_LOG2);
+        if (analog_ctx.ref191_data_12bits == ANALOG_ERROR_VALUE) {
+            bin->amplitude_mv = ANALOG_ERROR_VALUE;
+        }
+        else {
+            bin->amplitude_mv = (int32_t) ANALOG_MATHS_divide((amplitude_data * ANALOG_REF191_VOLTAGE_MV * ((uint32_t) analog_ctx.output_voltage_divider_ratio)), &(analog_ctx.output_voltage_reciprocal));
+        }
+    }
+}
+
+/*******************************************************************/
+static void _ANALOG_update_ripple(uint16_t* scan) {
+    // Local variables.
+    ANALOG_ripple_t* ripple = &(analog_ctx.ripple);
+    uint16_t data_12bits = scan[ANALOG_SCAN_INDEX_OUTPUT_VOLTAGE];
+    uint8_t extra_bits = (analog_ctx.oversampling[ANALOG_SCAN_INDEX_OUTPUT_VOLTAGE].resolution_bits - ANALOG_ADC_RESOLUTION_BITS);
+    int32_t deviation = 0;
+    uint64_t variance = 0;
+    // Accumulate the last samples of the period.
+    ripple->scan_count++;
+    if ((ripple->scan_count) <= (ANALOG_RIPPLE_PERIOD_SCANS - ANALOG_RIPPLE_BURST_SCANS)) goto errors;
+    // Start burst on first sample.
+    if ((ripple->scan_count) == (ANALOG_RIPPLE_PERIOD_SCANS - ANALOG_RIPPLE_BURST_SCANS + 1)) {
+        ripple->first_data_12bits = data_12bits;
+        ripple->min_data_12bits = data_12bits;
+        ripple->max_data_12bits = data_12bits;
+        ripple->sum = 0;
+        ripple->sum_of_squares = 0;
+    }
+    // Accumulate deviation from the first sample to keep the sum of squares small.
+    deviation = ((int32_t) data_12bits) - ((int32_t) ripple->first_data_12bits);
+    ripple->sum += deviation;
+    ripple->sum_of_squares += (uint64_t) (deviation * deviation);
+    _ANALOG_update_spectrum(deviation, extra_bits);
+    if (data_12bits < (ripple->min_data_12bits)) {
+        ripple->min_data_12bits = data_12bits;
+    }
+    if (data_12bits > (ripple->max_data_12bits)) {
+        ripple->max_data_12bits = data_12bits;
+    }
+    // Check end of burst.
+    if ((ripple->scan_count) < ANALOG_RIPPLE_PERIOD_SCANS) goto errors;
+    ripple->scan_count = 0;
+    // DC removal: N * variance = sum_of_squares - sum^2 / N, computed with the output voltage extra resolution bits.
+    variance = (ripple->sum_of_squares) - ((uint64_t) (((int64_t) ripple->sum) * ((int64_t) ripple->sum)) >> ANALOG_RIPPLE_BURST_SCANS_LOG2);
+    variance = ((variance << (extra_bits << 1)) >> ANALOG_RIPPLE_BURST_SCANS_LOG2);
+    ripple->rms_data = (int32_t) ANALOG_MATHS_sqrt(variance);
+    ripple->peak_to_peak_data = (((int32_t) ((ripple->max_data_12bits) - (ripple->min_data_12bits))) << extra_bits);
+errors:
+    return;
+}
+
+/*******************************************************************/
+static void _ANALOG_schedule(uint16_t* scan) {
+    // Local variables.
+    ANALOG_oversampling_t* oversampling = NULL;
+    uint8_t idx = 0;
+    // Update timestamp.
+    analog_ctx.timestamp_us += ANALOG_SCAN_PERIOD_US;
+    // Record raw samples at full rate.
+    _ANALOG_capture(scan);
+    _ANALOG_check_output_current_watchdog(scan);
+    _ANALOG_update_ripple(scan);
+    // Scan inputs.
+    for (idx = 0; idx < ANALOG_SCAN_INDEX_LAST; idx++) {
+        oversampling = &(analog_ctx.oversampling[idx]);
+        oversampling->scan_count++;
+        // Accumulate the last samples of the period.
+        if ((oversampling->scan_count) > (ANALOG_RATE[idx].period_scans - ANALOG_RATE[idx].ratio)) {
+            oversampling->sum += (uint32_t) scan[idx];
+            // Accumulate output voltage on the same scans as output current for power computation.
+            if (idx == ANALOG_SCAN_INDEX_OUTPUT_CURRENT) {
+                analog_ctx.output_voltage_aligned_sum += (uint32_t) scan[ANALOG_SCAN_INDEX_OUTPUT_VOLTAGE];
+            }
+        }
+        // Check period.
+        if ((oversampling->scan_count) >= ANALOG_RATE[idx].period_scans) {
+            // Decimate.
+            oversampling->raw_sum = (oversampling->sum);
+            oversampling->data = (int32_t) ((oversampling->sum) >> ANALOG_RATE[idx].shift);
+            if (idx == ANALOG_SCAN_INDEX_OUTPUT_CURRENT) {
+                analog_ctx.output_voltage_aligned_raw_sum = analog_ctx.output_voltage_aligned_sum;
+                analog_ctx.output_voltage_aligned_sum = 0;
+            }
+            // Reset accumulator.
+            oversampling->sum = 0;
+            oversampling->scan_count = 0;
+            // Process new data.
+            _ANALOG_process_input(idx);
+            if (idx == ANALOG_SCAN_INDEX_OUTPUT_CURRENT) {
+                analog_ctx.output_current_sequence++;
+            }
+        }
+    }
+}
+
+/*******************************************************************/
+static void _ANALOG_scan_block_cplt_irq_callback(uint16_t* block, uint16_t number_of_scans) {
+    // Local variables.
+    ANALOG_oversampling_t* oversampling = &(analog_ctx.oversampling[ANALOG_SCAN_INDEX_OUTPUT_CURRENT]);
+    uint16_t idx = 0;
+    // Restart output current window on the block following the request, so that all its samples are taken after the request.
+    if (analog_ctx.output_current_restart_state == ANALOG_OUTPUT_CURRENT_RESTART_STATE_SCHEDULED) {
+        oversampling->sum = 0;
+        oversampling->scan_count = (ANALOG_OUTPUT_CURRENT_PERIOD_SCANS - ANALOG_OUTPUT_CURRENT_RATIO);
+        analog_ctx.output_voltage_aligned_sum = 0;
+        analog_ctx.output_current_restart_sequence = analog_ctx.output_current_sequence;
+        analog_ctx.output_current_restart_state = ANALOG_OUTPUT_CURRENT_RESTART_STATE_IDLE;
+    }
+    if (analog_ctx.output_current_restart_state == ANALOG_OUTPUT_CURRENT_RESTART_STATE_REQUESTED) {
+        analog_ctx.output_current_restart_state = ANALOG_OUTPUT_CURRENT_RESTART_STATE_SCHEDULED;
+    }
+    // Run scheduler on all scans of the block.
+    for (idx = 0; idx < number_of_scans; idx++) {
+        _ANALOG_schedule(&(block[idx * ANALOG_SCAN_INDEX_LAST]));
+    }
+}
+
+/*******************************************************************/
+static void _ANALOG_trcs_process_callback(void) {
+    // Defer TRCS processing to main loop.
+    EVENT_post(EVENT_TRCS_PROCESS);
+}
+
+/*******************************************************************/
+static void _ANALOG_trcs_process_event_handler(void) {
+    // Local variables.
+    TRCS_status_t trcs_status = TRCS_SUCCESS;
+    TRCS_output_current_range_state_t trcs_output_current_range = TRCS_OUTPUT_CURRENT_RANGE_STATE_NONE;
+    int32_t output_current_ua = ANALOG_ERROR_VALUE;
+    // Process TRCS board.
+    if (analog_ctx.flags.trcs_started != 0) {
+        trcs_status = TRCS_process();
+        TRCS_stack_error(ERROR_BASE_ANALOG + ANALOG_ERROR_BASE_TRCS);
+        // Latch new sample, so that the ADC interrupt never enters the TRCS driver.
+        trcs_status = TRCS_get_output_current(&output_current_ua);
+        TRCS_stack_error(ERROR_BASE_ANALOG + ANALOG_ERROR_BASE_TRCS);
+        if (trcs_status != TRCS_SUCCESS) {
+            output_current_ua = ANALOG_ERROR_VALUE;
+        }
+        trcs_status = TRCS_get_output_current_range_state(&trcs_output_current_range);
+        TRCS_stack_error(ERROR_BASE_ANALOG + ANALOG_ERROR_BASE_TRCS);
+        _ANALOG_latch_trcs_sample(output_current_ua, (ANALOG_output_current_range_t) trcs_output_current_range);
+        _ANALOG_update_output_current_gain(output_current_ua, (ANALOG_output_current_range_t) trcs_output_current_range);
+    }
+}
+
+/*******************************************************************/
+static ANALOG_status_t _ANALOG_update_trcs_state(void) {
+    // Local variables.
+    ANALOG_status_t status = ANALOG_SUCCESS;
+    TRCS_status_t trcs_status = TRCS_SUCCESS;
+    // Update bypass switch state.
+    analog_ctx.flags.trcs_bypass = GPIO_read(&GPIO_TRCS_BYPASS);
+    // Check bypass flag change.
+    if (((analog_ctx.flags.trcs_bypass != 0) || (analog_ctx.flags.trcs_enable == 0)) && (analog_ctx.flags.trcs_started != 0)) {
+        // Update flag.
+        analog_ctx.flags.trcs_started = 0;
+        // Stop TRCS board and invalidate last sample.
+        trcs_status = TRCS_stop();
+        _ANALOG_latch_trcs_sample(ANALOG_ERROR_VALUE, ANALOG_OUTPUT_CURRENT_RANGE_NONE);
+        TRCS_exit_error(ANALOG_ERROR_BASE_TRCS);
+    }
+    if (((analog_ctx.flags.trcs_bypass == 0) && (analog_ctx.flags.trcs_enable != 0)) && (analog_ctx.flags.trcs_started == 0)) {
+        // Update flag.
+        analog_ctx.flags.trcs_started = 1;
+        // Start TRCS board.
+        trcs_status = TRCS_start(&_ANALOG_trcs_process_callback);
+        TRCS_exit_error(ANALOG_ERROR_BASE_TRCS);
+    }
+    return status;
+errors:
+    TRCS_stop();
+    analog_ctx.flags.trcs_started = 0;
+    _ANALOG_latch_trcs_sample(ANALOG_ERROR_VALUE, ANALOG_OUTPUT_CURRENT_RANGE_NONE);
+    return status;
+}
+
+/*******************************************************************/
+static void _ANALOG_bypass_timer_callback(void) {
+    // Local variables.
+    ANALOG_status_t analog_status = ANALOG_SUCCESS;
+    // Poll bypass switch.
+    analog_status = _ANALOG_update_trcs_state();
+    ANALOG_stack_error(ERROR_BASE_ANALOG);
+}
+
+/*** ANALOG functions ***/
+
+/*******************************************************************/
+ANALOG_status_t ANALOG_init(void) {
+    // Local variables.
+    ANALOG_status_t status = ANALOG_SUCCESS;
+    NVM_status_t nvm_status = NVM_SUCCESS;
+    ADC_SCAN_status_t adc_scan_status = ADC_SCAN_SUCCESS;
+    TRCS_status_t trcs_status = TRCS_SUCCESS;
+    EVENT_status_t event_status = EVENT_SUCCESS;
+    TIMER_status_t timer_status = TIMER_SUCCESS;
+    ADC_SCAN_configuration_t adc_scan_config;
+    uint8_t board_number = 0;
+    int32_t ts_cal1 = 0;
+    int32_t ts_cal2 = 0;
+    ADC_SCAN_sampling_time_t sampling_time = ADC_SCAN_SAMPLING_TIME_1_5_CYCLES;
+    uint16_t ratio = 0;
+    uint8_t idx = 0;
+    // Init context.
+    analog_ctx.output_voltage_divider_ratio = 0;
+    analog_ctx.output_voltage_divider_resistance_ohms = 1;
+    analog_ctx.flags.all = 0;
     analog_ctx.ref191_data_12bits = ANALOG_ERROR_VALUE;
-    analog_ctx.calibration_next_time_seconds = 0;
+    analog_ctx.ref191_average = 0;
+    analog_ctx.ref191_applied_data = 0;
+    analog_ctx.calibration_outlier_count = 0;
+    analog_ctx.calibration_fast_count = 0;
+    analog_ctx.calibration_vrefint_data_12bits = 0;
+    analog_ctx.calibration_temperature_degrees = 0;
+    analog_ctx.capture.state = ANALOG_CAPTURE_STATE_IDLE;
+    analog_ctx.ripple.scan_count = (ANALOG_RIPPLE_PERIOD_SCANS - ANALOG_RIPPLE_BURST_SCANS);
+    analog_ctx.ripple.peak_to_peak_data = ANALOG_ERROR_VALUE;
+    analog_ctx.ripple.rms_data = ANALOG_ERROR_VALUE;
+    for (idx = 0; idx < ANALOG_SPECTRUM_NUMBER_OF_BINS; idx++) {
+        analog_ctx.spectrum[idx].enable = 0;
+        analog_ctx.spectrum[idx].active = 0;
+        analog_ctx.spectrum[idx].frequency_hz = 0;
+        analog_ctx.spectrum[idx].amplitude_mv = ANALOG_ERROR_VALUE;
+    }
+    analog_ctx.timestamp_us = 0;
+    analog_ctx.snapshot_sequence = 0;
+    analog_ctx.output_voltage_aligned_sum = 0;
+    analog_ctx.output_voltage_aligned_raw_sum = 0;
+    analog_ctx.output_current_restart_state = ANALOG_OUTPUT_CURRENT_RESTART_STATE_IDLE;
+    analog_ctx.output_current_sequence = 0;
+    analog_ctx.output_current_restart_sequence = 0;
+    analog_ctx.trcs_output_current_ua = ANALOG_ERROR_VALUE;
+    analog_ctx.trcs_output_current_range = ANALOG_OUTPUT_CURRENT_RANGE_NONE;
+    analog_ctx.trcs_sequence = 0;
+    analog_ctx.trcs_converted_sequence = 0;
+    analog_ctx.trcs_sample_update = 0;
+    analog_ctx.energy_sequence = 0;
+    analog_ctx.energy.number_of_periods = 0;
+    analog_ctx.energy.output_charge_ua_periods = 0;
+    analog_ctx.energy.output_energy_uw_periods = 0;
+    analog_ctx.energy_origin = analog_ctx.energy;
+    for (idx = 0; idx < ANALOG_SUBSCRIPTIONS_MAX; idx++) {
+        analog_ctx.subscriptions[idx].data_ready_callback = NULL;
+    }
+    analog_ctx.statistics_sequence = 0;
+    analog_ctx.quantile_reset_request = 0;
+    analog_ctx.quantile_number_of_samples = 0;
+    for (idx = 0; idx < ANALOG_QUANTILE_NUMBER_OF_BUCKETS; idx++) {
+        analog_ctx.quantile_histogram[idx] = 0;
+    }
+    for (idx = 0; idx < ANALOG_STATISTICS_MAX; idx++) {
+        analog_ctx.statistics[idx].enable = 0;
+    }
+    for (idx = 0; idx < ANALOG_ALARM_LAST; idx++) {
+        analog_ctx.alarms[idx].enable = 0;
+        analog_ctx.alarms[idx].latched = 0;
+        analog_ctx.alarms[idx].notified = 0;
+    }
+    for (idx = 0; idx < ANALOG_ALARM_CALLBACKS_MAX; idx++) {
+        analog_ctx.alarm_callbacks[idx] = NULL;
+    }
+    for (idx = 0; idx < ANALOG_OUTPUT_CURRENT_RANGE_LAST; idx++) {
+        analog_ctx.output_current_gain[idx] = 0;
+        analog_ctx.output_current_threshold_data_12bits[idx] = ANALOG_CURRENT_ALARM_DISARMED;
+    }
+    analog_ctx.output_current_alarm_count = 0;
+    analog_ctx.journal_flags.all = 0;
+    analog_ctx.journal_output_current_range = ANALOG_OUTPUT_CURRENT_RANGE_NONE;
+    analog_ctx.journal_output_current_ua = ANALOG_ERROR_VALUE;
+    analog_ctx.journal_sequence = 0;
+    analog_ctx.blanking_count = 0;
+    analog_ctx.output_current_valid = 0;
     // Init data.
     for (idx = 0; idx < ANALOG_CHANNEL_LAST; idx++) {
         analog_ctx.data[idx] = 0;
+        analog_ctx.filtered_data[idx] = 0;
+        analog_ctx.filter[idx].enable = 0;
+        analog_ctx.integrator[idx] = 0;
+        analog_ctx.integrator_number_of_samples[idx] = 0;
+    }
+    // Init scheduler.
+    for (idx = 0; idx < ANALOG_SCAN_INDEX_LAST; idx++) {
+        // Start with a complete period so that all channels are converted on first scans.
+        analog_ctx.oversampling[idx].scan_count = (ANALOG_RATE[idx].period_scans - ANALOG_RATE[idx].ratio);
+        analog_ctx.oversampling[idx].sum = 0;
+        analog_ctx.oversampling[idx].raw_sum = 0;
+        analog_ctx.oversampling[idx].data = 0;
+        // Compute effective resolution.
+        analog_ctx.oversampling[idx].resolution_bits = (ANALOG_ADC_RESOLUTION_BITS - ANALOG_RATE[idx].shift);
+        for (ratio = ANALOG_RATE[idx].ratio; ratio > 1; ratio >>= 1) {
+            analog_ctx.oversampling[idx].resolution_bits++;
+        }
+        // Use the longest sampling time required by the scan inputs.
+        if (ANALOG_RATE[idx].sampling_time > sampling_time) {
+            sampling_time = ANALOG_RATE[idx].sampling_time;
+        }
     }
     // Read board number.
     nvm_status = NVM_read_byte(NVM_ADDRESS_BOARD_NUMBER, &board_number);
@@ -229,23 +1660,55 @@ ANALOG_status_t ANALOG_init(void) {
         status = ANALOG_ERROR_BOARD_NUMBER;
         goto errors;
     }
+    // Default spectrum bins on mains ripple.
+    status = ANALOG_set_spectrum_bin(0, ANALOG_SPECTRUM_DEFAULT_BIN_0_HZ);
+    if (status != ANALOG_SUCCESS) goto errors;
+    status = ANALOG_set_spectrum_bin(1, ANALOG_SPECTRUM_DEFAULT_BIN_1_HZ);
+    if (status != ANALOG_SUCCESS) goto errors;
+    // Output voltage thresholds reciprocal.
+    ANALOG_MATHS_compute_reciprocal((uint32_t) (ANALOG_REF191_VOLTAGE_MV * analog_ctx.output_voltage_divider_ratio), (ANALOG_MCU_VOLTAGE_MV_MAX * ANALOG_ADC_FULL_SCALE), &(analog_ctx.output_voltage_threshold_reciprocal));
+    // Temperature sensor reciprocal from factory calibration.
+    ts_cal1 = (int32_t) (*ANALOG_TS_CAL1_ADDRESS);
+    ts_cal2 = (int32_t) (*ANALOG_TS_CAL2_ADDRESS);
+    if (ts_cal2 <= ts_cal1) {
+        status = ANALOG_ERROR_TEMPERATURE_CALIBRATION;
+        goto errors;
+    }
+    analog_ctx.ts_cal1_data_scaled = (ts_cal1 * ANALOG_TS_CAL_VDDA_MV);
+    ANALOG_MATHS_compute_reciprocal((uint32_t) (((ANALOG_TS_CAL_VDDA_MV / (ANALOG_TS_CAL2_TEMPERATURE_DEGREES - ANALOG_TS_CAL1_TEMPERATURE_DEGREES))) * (ts_cal2 - ts_cal1)), (ANALOG_MCU_VOLTAGE_MV_MAX << ANALOG_ADC_RESOLUTION_BITS), &(analog_ctx.mcu_temperature_reciprocal));
     // Init bypass detect.
     GPIO_configure(&GPIO_TRCS_BYPASS, GPIO_MODE_INPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
-    // Init internal ADC.
-    adc_status = ADC_init(&GPIO_ADC_GPIO);
-    ADC_exit_error(ANALOG_ERROR_BASE_ADC);
-    // Init sampling timer.
-    tim_status = TIM_STD_init(TIM_INSTANCE_ANALOG, NVIC_PRIORITY_ANALOG_TIMER);
-    TIM_exit_error(ANALOG_ERROR_BASE_TIM);
+    analog_ctx.flags.trcs_bypass = GPIO_read(&GPIO_TRCS_BYPASS);
+    // Init hardware triggered scan (the scan driver owns the internal ADC, the generic ADC driver is only used for conversion formulas).
+    adc_scan_config.gpio_list = GPIO_ADC_GPIO.list;
+    adc_scan_config.gpio_list_size = GPIO_ADC_GPIO.list_size;
+    adc_scan_config.channel_mask = ANALOG_SCAN_CHANNEL_MASK;
+    adc_scan_config.sampling_time = sampling_time;
+    adc_scan_config.buffer = analog_ctx.scan_buffer;
+    adc_scan_config.number_of_scans_per_block = ANALOG_SCAN_NUMBER_OF_SCANS_PER_BLOCK;
+    adc_scan_config.block_cplt_irq_callback = &_ANALOG_scan_block_cplt_irq_callback;
+    adc_scan_config.nvic_priority = NVIC_PRIORITY_ANALOG_DMA;
+    adc_scan_config.watchdog_irq_callback = &_ANALOG_watchdog_irq_callback;
+    adc_scan_config.watchdog_nvic_priority = NVIC_PRIORITY_ANALOG_WATCHDOG;
+    adc_scan_status = ADC_SCAN_init(&adc_scan_config);
+    ADC_SCAN_exit_error(ANALOG_ERROR_BASE_ADC_SCAN);
     // Init TRCS board.
     trcs_status = TRCS_init();
     TRCS_exit_error(ANALOG_ERROR_BASE_TRCS);
-    // First calibration.
-    status = _ANALOG_calibrate();
-    if (status != ANALOG_SUCCESS) goto errors;
-    // Start sampling timer.
-    tim_status = TIM_STD_start(TIM_INSTANCE_ANALOG, ANALOG_TIMER_PERIOD_MS, TIM_UNIT_MS, &_ANALOG_timer_irq_callback);
-    TIM_exit_error(TRCS_ERROR_BASE_TIMER);
+    event_status = EVENT_register(EVENT_TRCS_PROCESS, &_ANALOG_trcs_process_event_handler);
+    EVENT_exit_error(ANALOG_ERROR_BASE_EVENT);
+    // Both alarm sources share the same notification handler.
+    event_status = EVENT_register(EVENT_ANALOG_WATCHDOG, &_ANALOG_alarm_event_handler);
+    EVENT_exit_error(ANALOG_ERROR_BASE_EVENT);
+    event_status = EVENT_register(EVENT_ANALOG_ALARM, &_ANALOG_alarm_event_handler);
+    EVENT_exit_error(ANALOG_ERROR_BASE_EVENT);
+    // Poll bypass switch from the main loop.
+    timer_status = TIMER_start(&(analog_ctx.bypass_timer), ANALOG_BYPASS_PERIOD_MS, TIMER_MODE_PERIODIC, TIMER_DISPATCH_TASK, &_ANALOG_bypass_timer_callback);
+    TIMER_exit_error(ANALOG_ERROR_BASE_TIMER);
+    // Start scan (first calibration is performed on first reference data).
+    analog_ctx.timestamp_us = TIMER_get_time_us();
+    adc_scan_status = ADC_SCAN_start(ANALOG_SCAN_PERIOD_US);
+    ADC_SCAN_exit_error(ANALOG_ERROR_BASE_ADC_SCAN);
 errors:
     return status;
 }
@@ -255,22 +1718,19 @@ ANALOG_status_t ANALOG_de_init(void) {
     // Local variables.
     ANALOG_status_t status = ANALOG_SUCCESS;
     TRCS_status_t trcs_status = TRCS_SUCCESS;
-    ADC_status_t adc_status = ADC_SUCCESS;
-    TIM_status_t tim_status = TIM_SUCCESS;
+    ADC_SCAN_status_t adc_scan_status = ADC_SCAN_SUCCESS;
+    TIMER_status_t timer_status = TIMER_SUCCESS;
+    // Stop bypass switch polling.
+    timer_status = TIMER_stop(&(analog_ctx.bypass_timer));
+    TIMER_stack_error(ERROR_BASE_ANALOG + ANALOG_ERROR_BASE_TIMER);
     // Erase calibration value.
     analog_ctx.ref191_data_12bits = ANALOG_ERROR_VALUE;
-    // Stop sampling timer.
-    tim_status = TIM_STD_stop(TIM_INSTANCE_ANALOG);
-    TIM_stack_error(ERROR_BASE_ANALOG + TRCS_ERROR_BASE_TIMER);
+    // Release scan.
+    adc_scan_status = ADC_SCAN_de_init();
+    ADC_SCAN_stack_error(ERROR_BASE_ANALOG + ANALOG_ERROR_BASE_ADC_SCAN);
     // Init TRCS board.
     trcs_status = TRCS_de_init();
     TRCS_stack_error(ERROR_BASE_ANALOG + ANALOG_ERROR_BASE_TRCS);
-    // Release internal ADC.
-    adc_status = ADC_de_init();
-    ADC_stack_error(ERROR_BASE_ANALOG + ANALOG_ERROR_BASE_ADC);
-    // Release sampling timer.
-    tim_status = TIM_STD_de_init(TIM_INSTANCE_ANALOG);
-    TIM_stack_error(ERROR_BASE_ANALOG + ANALOG_ERROR_BASE_TIM);
     return status;
 }
 
@@ -278,8 +1738,9 @@ ANALOG_status_t ANALOG_de_init(void) {
 ANALOG_status_t ANALOG_start_trcs(void) {
     // Local variables.
     ANALOG_status_t status = ANALOG_SUCCESS;
-    // Update local flag.
+    // Update local flag and start TRCS board if the bypass switch is off.
     analog_ctx.flags.trcs_enable = 1;
+    status = _ANALOG_update_trcs_state();
     return status;
 }
 
@@ -287,62 +1748,60 @@ ANALOG_status_t ANALOG_start_trcs(void) {
 ANALOG_status_t ANALOG_stop_trcs(void) {
     // Local variables.
     ANALOG_status_t status = ANALOG_SUCCESS;
-    // Update local flag.
+    // Update local flag and stop TRCS board.
     analog_ctx.flags.trcs_enable = 0;
+    status = _ANALOG_update_trcs_state();
     return status;
 }
 
 /*******************************************************************/
-ANALOG_status_t ANALOG_process(void) {
+ANALOG_status_t ANALOG_read_channel(ANALOG_channel_t channel, int32_t* analog_data) {
     // Local variables.
     ANALOG_status_t status = ANALOG_SUCCESS;
-    TRCS_status_t trcs_status = TRCS_SUCCESS;
-    // Update bypass switch state.
-    analog_ctx.flags.trcs_bypass = GPIO_read(&GPIO_TRCS_BYPASS);
-    // Check bypass flag change.
-    if (((analog_ctx.flags.trcs_bypass != 0) || (analog_ctx.flags.trcs_enable == 0)) && (analog_ctx.flags.trcs_started != 0)) {
-        // Update flag.
-        analog_ctx.flags.trcs_started = 0;
-        // Stop TRCS board.
-        trcs_status = TRCS_stop();
-        TRCS_exit_error(ANALOG_ERROR_BASE_TRCS);
-    }
-    if (((analog_ctx.flags.trcs_bypass == 0) && (analog_ctx.flags.trcs_enable != 0)) && (analog_ctx.flags.trcs_started == 0)) {
-        // Update flag.
-        analog_ctx.flags.trcs_started = 1;
-        // Stop TRCS board.
-        trcs_status = TRCS_start(&_ANALOG_trcs_process_callback);
-        TRCS_exit_error(ANALOG_ERROR_BASE_TRCS);
+    // Check parameters.
+    if (channel >= ANALOG_CHANNEL_LAST) {
+        status = ANALOG_ERROR_CHANNEL;
+        goto errors;
     }
-    // Check calibration period.
-    if (RTC_get_uptime_seconds() >= analog_ctx.calibration_next_time_seconds) {
-        // Update next time.
-        analog_ctx.calibration_next_time_seconds += ANALOG_CALIBRATION_PERIOD_SECONDS;
-        // Convert bandgap.
-        status = _ANALOG_calibrate();
-        if (status != ANALOG_SUCCESS) goto errors;
+    if (analog_data == NULL) {
+        status = ANALOG_ERROR_NULL_PARAMETER;
+        goto errors;
     }
-    return status;
+    (*analog_data) = analog_ctx.data[channel];
 errors:
-    TRCS_stop();
-    analog_ctx.flags.trcs_started = 0;
     return status;
 }
 
 /*******************************************************************/
-ANALOG_status_t ANALOG_read_channel(ANALOG_channel_t channel, int32_t* analog_data) {
+ANALOG_status_t ANALOG_convert_output_current(int32_t* output_current_mv) {
     // Local variables.
     ANALOG_status_t status = ANALOG_SUCCESS;
-    // Check parameters.
-    if (channel >= ANALOG_CHANNEL_LAST) {
-        status = ANALOG_ERROR_CHANNEL;
+    uint64_t start_time_us = 0;
+    // Check parameter.
+    if (output_current_mv == NULL) {
+        status = ANALOG_ERROR_NULL_PARAMETER;
         goto errors;
     }
-    if (analog_data == NULL) {
-        status = ANALOG_ERROR_NULL_PARAMETER;
+    // Busy wait relies on the scan interrupt: never block an interrupt handler.
+    if (_ANALOG_is_main_context() == 0) {
+        status = ANALOG_ERROR_CONTEXT;
         goto errors;
     }
-    (*analog_data) = analog_ctx.data[channel];
+    // Check calibration.
+    if (analog_ctx.ref191_data_12bits == ANALOG_ERROR_VALUE) {
+        status = ANALOG_ERROR_CALIBRATION_MISSING;
+        goto errors;
+    }
+    // Discard current window and wait for a conversion entirely sampled after the request.
+    start_time_us = TIMER_get_time_us();
+    analog_ctx.output_current_restart_state = ANALOG_OUTPUT_CURRENT_RESTART_STATE_REQUESTED;
+    while ((analog_ctx.output_current_restart_state != ANALOG_OUTPUT_CURRENT_RESTART_STATE_IDLE) || (analog_ctx.output_current_sequence == analog_ctx.output_current_restart_sequence)) {
+        if ((TIMER_get_time_us() - start_time_us) > ANALOG_OUTPUT_CURRENT_TIMEOUT_US) {
+            status = ANALOG_ERROR_OUTPUT_CURRENT_TIMEOUT;
+            goto errors;
+        }
+    }
+    (*output_current_mv) = analog_ctx.data[ANALOG_CHANNEL_OUTPUT_CURRENT_MV];
 errors:
     return status;
 }
@@ -385,3 +1844,681 @@ ANALOG_status_t ANALOG_get_output_current_range(ANALOG_output_current_range_t* o
 errors:
     return status;
 }
+
+/*******************************************************************/
+ANALOG_status_t ANALOG_read_snapshot(ANALOG_snapshot_t* snapshot) {
+    // Local variables.
+    ANALOG_status_t status = ANALOG_SUCCESS;
+    uint32_t sequence = 0;
+    // Check parameter.
+    if (snapshot == NULL) {
+        status = ANALOG_ERROR_NULL_PARAMETER;
+        goto errors;
+    }
+    // Copy published buffer until it was not updated during the copy.
+    do {
+        sequence = analog_ctx.snapshot_sequence;
+        (*snapshot) = analog_ctx.snapshot[sequence & 0x01];
+    }
+    while (sequence != analog_ctx.snapshot_sequence);
+errors:
+    return status;
+}
+
+/*******************************************************************/
+ANALOG_status_t ANALOG_set_filter(ANALOG_channel_t channel, ANALOG_filter_configuration_t* configuration) {
+    // Local variables.
+    ANALOG_status_t status = ANALOG_SUCCESS;
+    ANALOG_filter_t* filter = NULL;
+    uint32_t sampling_period_us = 0;
+    // Check parameters.
+    if (channel >= ANALOG_CHANNEL_LAST) {
+        status = ANALOG_ERROR_CHANNEL;
+        goto errors;
+    }
+    if (configuration == NULL) {
+        status = ANALOG_ERROR_NULL_PARAMETER;
+        goto errors;
+    }
+    if (((configuration->median_taps) != 1) && ((configuration->median_taps) != 3) && ((configuration->median_taps) != ANALOG_FILTER_MEDIAN_TAPS_MAX)) {
+        status = ANALOG_ERROR_FILTER_MEDIAN_TAPS;
+        goto errors;
+    }
+    filter = &(analog_ctx.filter[channel]);
+    // Disable filter during update.
+    filter->enable = 0;
+    analog_ctx.filtered_data[channel] = analog_ctx.data[channel];
+    // Low pass coefficient: alpha = T / (tau + T).
+    sampling_period_us = ((uint32_t) ANALOG_RATE[ANALOG_CHANNEL_SCAN_INDEX[channel]].period_scans) * ANALOG_SCAN_PERIOD_US;
+    filter->alpha = 0;
+    if ((configuration->time_constant_ms) != 0) {
+        filter->alpha = (uint32_t) ((((uint64_t) sampling_period_us) << ANALOG_FILTER_ALPHA_BITS) / (((uint64_t) (configuration->time_constant_ms)) * 1000 + sampling_period_us));
+    }
+    filter->median_taps = (configuration->median_taps);
+    filter->step_threshold = (configuration->step_threshold);
+    filter->history_index = 0;
+    filter->history_count = 0;
+    // Enable filter if needed.
+    if (((filter->median_taps) > 1) || ((filter->alpha) != 0)) {
+        filter->enable = 1;
+    }
+errors:
+    return status;
+}
+
+/*******************************************************************/
+ANALOG_status_t ANALOG_subscribe(ANALOG_channel_t channel, uint16_t decimation, ANALOG_data_ready_cb_t data_ready_callback) {
+    // Local variables.
+    ANALOG_status_t status = ANALOG_SUCCESS;
+    ANALOG_subscription_t* subscription = NULL;
+    uint8_t idx = 0;
+    // Check parameters.
+    if (channel >= ANALOG_CHANNEL_LAST) {
+        status = ANALOG_ERROR_CHANNEL;
+        goto errors;
+    }
+    if (decimation == 0) {
+        status = ANALOG_ERROR_DECIMATION;
+        goto errors;
+    }
+    if (data_ready_callback == NULL) {
+        status = ANALOG_ERROR_NULL_PARAMETER;
+        goto errors;
+    }
+    // Search free slot.
+    for (idx = 0; idx < ANALOG_SUBSCRIPTIONS_MAX; idx++) {
+        if (analog_ctx.subscriptions[idx].data_ready_callback == NULL) {
+            subscription = &(analog_ctx.subscriptions[idx]);
+            break;
+        }
+    }
+    if (subscription == NULL) {
+        status = ANALOG_ERROR_SUBSCRIPTION_FULL;
+        goto errors;
+    }
+    // Register subscription (callback is written last to activate it).
+    subscription->channel = channel;
+    subscription->decimation = decimation;
+    subscription->count = 0;
+    subscription->origin_valid = 0;
+    subscription->data_ready_callback = data_ready_callback;
+errors:
+    return status;
+}
+
+/*******************************************************************/
+ANALOG_status_t ANALOG_unsubscribe(ANALOG_channel_t channel, ANALOG_data_ready_cb_t data_ready_callback) {
+    // Local variables.
+    ANALOG_status_t status = ANALOG_ERROR_SUBSCRIPTION_NOT_FOUND;
+    uint8_t idx = 0;
+    // Check parameter.
+    if (data_ready_callback == NULL) {
+        status = ANALOG_ERROR_NULL_PARAMETER;
+        goto errors;
+    }
+    // Search subscription.
+    for (idx = 0; idx < ANALOG_SUBSCRIPTIONS_MAX; idx++) {
+        if ((analog_ctx.subscriptions[idx].data_ready_callback == data_ready_callback) && (analog_ctx.subscriptions[idx].channel == channel)) {
+            analog_ctx.subscriptions[idx].data_ready_callback = NULL;
+            status = ANALOG_SUCCESS;
+            break;
+        }
+    }
+errors:
+    return status;
+}
+
+/*******************************************************************/
+ANALOG_status_t ANALOG_read_raw_sum(ANALOG_channel_t channel, uint32_t* raw_sum, uint16_t* number_of_samples) {
+    // Local variables.
+    ANALOG_status_t status = ANALOG_SUCCESS;
+    ANALOG_scan_index_t scan_index = ANALOG_SCAN_INDEX_LAST;
+    // Check parameters (computed channels have no raw sum).
+    if (channel >= ANALOG_CHANNEL_OUTPUT_CURRENT_UA) {
+        status = ANALOG_ERROR_CHANNEL;
+        goto errors;
+    }
+    if ((raw_sum == NULL) || (number_of_samples == NULL)) {
+        status = ANALOG_ERROR_NULL_PARAMETER;
+        goto errors;
+    }
+    scan_index = ANALOG_CHANNEL_SCAN_INDEX[channel];
+    (*raw_sum) = analog_ctx.oversampling[scan_index].raw_sum;
+    (*number_of_samples) = ANALOG_RATE[scan_index].ratio;
+errors:
+    return status;
+}
+
+/*******************************************************************/
+ANALOG_status_t ANALOG_arm_capture(ANALOG_capture_trigger_t trigger, int32_t threshold_mv, uint16_t pre_trigger_samples) {
+    // Local variables.
+    ANALOG_status_t status = ANALOG_SUCCESS;
+    int64_t threshold_data_12bits = 0;
+    // Check parameters.
+    if (trigger >= ANALOG_CAPTURE_TRIGGER_LAST) {
+        status = ANALOG_ERROR_CAPTURE_TRIGGER;
+        goto errors;
+    }
+    if (pre_trigger_samples >= ANALOG_CAPTURE_DEPTH) {
+        status = ANALOG_ERROR_CAPTURE_PRE_TRIGGER_SAMPLES;
+        goto errors;
+    }
+    // Check calibration.
+    if (analog_ctx.ref191_data_12bits == ANALOG_ERROR_VALUE) {
+        status = ANALOG_ERROR_CALIBRATION_MISSING;
+        goto errors;
+    }
+    // Convert threshold to ADC data (64 bits product since the threshold is not bounded).
+    if (threshold_mv < 0) {
+        threshold_mv = 0;
+    }
+    switch (trigger) {
+    case ANALOG_CAPTURE_TRIGGER_CURRENT_STEP:
+        threshold_data_12bits = (((int64_t) threshold_mv) * ((int64_t) analog_ctx.ref191_data_12bits)) / (ANALOG_REF191_VOLTAGE_MV);
+        break;
+    case ANALOG_CAPTURE_TRIGGER_VOLTAGE_DROOP:
+        threshold_data_12bits = (((int64_t) threshold_mv) * ((int64_t) analog_ctx.ref191_data_12bits)) / (ANALOG_REF191_VOLTAGE_MV * analog_ctx.output_voltage_divider_ratio);
+        break;
+    default:
+        break;
+    }
+    if (threshold_data_12bits > ANALOG_ADC_FULL_SCALE) {
+        threshold_data_12bits = ANALOG_ADC_FULL_SCALE;
+    }
+    // Stop current capture.
+    analog_ctx.capture.state = ANALOG_CAPTURE_STATE_IDLE;
+    // Init capture.
+    analog_ctx.capture.trigger = trigger;
+    analog_ctx.capture.threshold_data_12bits = (uint16_t) threshold_data_12bits;
+    analog_ctx.capture.pre_trigger_samples = pre_trigger_samples;
+    analog_ctx.capture.sample_count = 0;
+    analog_ctx.capture.post_trigger_count = 0;
+    analog_ctx.capture.write_index = 0;
+    // Start recording.
+    analog_ctx.capture.state = ANALOG_CAPTURE_STATE_ARMED;
+errors:
+    return status;
+}
+
+/*******************************************************************/
+ANALOG_status_t ANALOG_trigger_capture(void) {
+    // Local variables.
+    ANALOG_status_t status = ANALOG_SUCCESS;
+    // Check state.
+    if (analog_ctx.capture.state != ANALOG_CAPTURE_STATE_ARMED) {
+        status = ANALOG_ERROR_CAPTURE_STATE;
+        goto errors;
+    }
+    // Force trigger.
+    analog_ctx.capture.state = ANALOG_CAPTURE_STATE_TRIGGERED;
+errors:
+    return status;
+}
+
+/*******************************************************************/
+ANALOG_status_t ANALOG_get_capture_information(ANALOG_capture_information_t* capture_information) {
+    // Local variables.
+    ANALOG_status_t status = ANALOG_SUCCESS;
+    // Check parameter.
+    if (capture_information == NULL) {
+        status = ANALOG_ERROR_NULL_PARAMETER;
+        goto errors;
+    }
+    capture_information->state = analog_ctx.capture.state;
+    capture_information->sampling_period_us = ANALOG_SCAN_PERIOD_US;
+    capture_information->number_of_samples = 0;
+    capture_information->trigger_index = 0;
+    // Buffer is only valid when complete.
+    if (analog_ctx.capture.state == ANALOG_CAPTURE_STATE_COMPLETE) {
+        capture_information->number_of_samples = analog_ctx.capture.sample_count;
+        capture_information->trigger_index = (analog_ctx.capture.sample_count - (ANALOG_CAPTURE_DEPTH - analog_ctx.capture.pre_trigger_samples));
+    }
+errors:
+    return status;
+}
+
+/*******************************************************************/
+ANALOG_status_t ANALOG_read_capture_sample(uint16_t sample_index, int32_t* output_voltage_mv, int32_t* output_current_mv) {
+    // Local variables.
+    ANALOG_status_t status = ANALOG_SUCCESS;
+    ANALOG_capture_sample_t* sample = NULL;
+    uint32_t adc_data = 0;
+    // Check parameters.
+    if ((output_voltage_mv == NULL) || (output_current_mv == NULL)) {
+        status = ANALOG_ERROR_NULL_PARAMETER;
+        goto errors;
+    }
+    if (analog_ctx.capture.state != ANALOG_CAPTURE_STATE_COMPLETE) {
+        status = ANALOG_ERROR_CAPTURE_STATE;
+        goto errors;
+    }
+    if (sample_index >= analog_ctx.capture.sample_count) {
+        status = ANALOG_ERROR_CAPTURE_INDEX;
+        goto errors;
+    }
+    // Oldest sample is located at write index when the buffer is full.
+    sample = &(analog_ctx.capture.buffer[(analog_ctx.capture.write_index - analog_ctx.capture.sample_count + sample_index) & (ANALOG_CAPTURE_DEPTH - 1)]);
+    // Convert to mV with the channels resolution.
+    adc_data = ((uint32_t) sample->output_voltage_data_12bits) << (analog_ctx.oversampling[ANALOG_SCAN_INDEX_OUTPUT_VOLTAGE].resolution_bits - ANALOG_ADC_RESOLUTION_BITS);
+    (*output_voltage_mv) = (int32_t) ANALOG_MATHS_divide((adc_data * ANALOG_REF191_VOLTAGE_MV * ((uint32_t) analog_ctx.output_voltage_divider_ratio)), &(analog_ctx.output_voltage_reciprocal));
+    adc_data = ((uint32_t) sample->output_current_data_12bits) << (analog_ctx.oversampling[ANALOG_SCAN_INDEX_OUTPUT_CURRENT].resolution_bits - ANALOG_ADC_RESOLUTION_BITS);
+    (*output_current_mv) = (int32_t) ANALOG_MATHS_divide((adc_data * ANALOG_REF191_VOLTAGE_MV), &(analog_ctx.output_current_reciprocal));
+errors:
+    return status;
+}
+
+/*******************************************************************/
+ANALOG_status_t ANALOG_reset_energy(void) {
+    // Local variables.
+    ANALOG_status_t status = ANALOG_SUCCESS;
+    // Accumulators are only written under interrupt, reset is done by moving the origin.
+    _ANALOG_read_energy_accumulator(&(analog_ctx.energy_origin));
+    return status;
+}
+
+/*******************************************************************/
+ANALOG_status_t ANALOG_read_energy(ANALOG_energy_t* energy) {
+    // Local variables.
+    ANALOG_status_t status = ANALOG_SUCCESS;
+    ANALOG_energy_accumulator_t accumulator;
+    // Check parameter.
+    if (energy == NULL) {
+        status = ANALOG_ERROR_NULL_PARAMETER;
+        goto errors;
+    }
+    // Read accumulators.
+    _ANALOG_read_energy_accumulator(&accumulator);
+    // Convert from periods to physical units.
+    energy->duration_us = (accumulator.number_of_periods - analog_ctx.energy_origin.number_of_periods) * ANALOG_ENERGY_PERIOD_US;
+    energy->output_charge_uah = (accumulator.output_charge_ua_periods - analog_ctx.energy_origin.output_charge_ua_periods) / ANALOG_ENERGY_PERIODS_PER_HOUR;
+    energy->output_energy_uwh = (accumulator.output_energy_uw_periods - analog_ctx.energy_origin.output_energy_uw_periods) / ANALOG_ENERGY_PERIODS_PER_HOUR;
+errors:
+    return status;
+}
+
+/*******************************************************************/
+ANALOG_status_t ANALOG_open_statistics(ANALOG_channel_t channel, uint8_t* statistics_id) {
+    // Local variables.
+    ANALOG_status_t status = ANALOG_ERROR_STATISTICS_FULL;
+    ANALOG_statistics_slot_t* slot = NULL;
+    uint8_t idx = 0;
+    // Check parameters.
+    if (channel >= ANALOG_CHANNEL_LAST) {
+        status = ANALOG_ERROR_CHANNEL;
+        goto errors;
+    }
+    if (statistics_id == NULL) {
+        status = ANALOG_ERROR_NULL_PARAMETER;
+        goto errors;
+    }
+    // Search free slot.
+    for (idx = 0; idx < ANALOG_STATISTICS_MAX; idx++) {
+        slot = &(analog_ctx.statistics[idx]);
+        if ((slot->enable) != 0) continue;
+        // Init slot (enable flag is written last to activate it).
+        slot->channel = channel;
+        slot->active_window = 0;
+        slot->window[0].number_of_samples = 0;
+        slot->window[1].number_of_samples = 0;
+        slot->enable = 1;
+        (*statistics_id) = idx;
+        status = ANALOG_SUCCESS;
+        break;
+    }
+errors:
+    return status;
+}
+
+/*******************************************************************/
+ANALOG_status_t ANALOG_close_statistics(uint8_t statistics_id) {
+    // Local variables.
+    ANALOG_status_t status = ANALOG_SUCCESS;
+    // Check parameter.
+    if ((statistics_id >= ANALOG_STATISTICS_MAX) || (analog_ctx.statistics[statistics_id].enable == 0)) {
+        status = ANALOG_ERROR_STATISTICS_ID;
+        goto errors;
+    }
+    // Release slot.
+    analog_ctx.statistics[statistics_id].enable = 0;
+errors:
+    return status;
+}
+
+/*******************************************************************/
+ANALOG_status_t ANALOG_read_statistics(uint8_t statistics_id, uint8_t reset, ANALOG_statistics_t* statistics) {
+    // Local variables.
+    ANALOG_status_t status = ANALOG_SUCCESS;
+    ANALOG_statistics_slot_t* slot = NULL;
+    ANALOG_statistics_window_t window;
+    uint32_t sequence = 0;
+    uint32_t primask = 0;
+    uint8_t active_window = 0;
+    int64_t mean_deviation = 0;
+    uint64_t mean_square_deviation = 0;
+    // Check parameters.
+    if ((statistics_id >= ANALOG_STATISTICS_MAX) || (analog_ctx.statistics[statistics_id].enable == 0)) {
+        status = ANALOG_ERROR_STATISTICS_ID;
+        goto errors;
+    }
+    if (statistics == NULL) {
+        status = ANALOG_ERROR_NULL_PARAMETER;
+        goto errors;
+    }
+    slot = &(analog_ctx.statistics[statistics_id]);
+    if (reset != 0) {
+        // Swap windows and copy the previous one with the interrupt masked, so that no sample is lost nor counted twice.
+        primask = _ANALOG_enter_critical();
+        active_window = (slot->active_window);
+        slot->window[active_window ^ 0x01].number_of_samples = 0;
+        slot->active_window = (active_window ^ 0x01);
+        window = slot->window[active_window];
+        _ANALOG_exit_critical(primask);
+    }
+    else {
+        // Copy active window until it was not updated during the copy.
+        do {
+            sequence = analog_ctx.statistics_sequence;
+            _ANALOG_compiler_barrier();
+            active_window = (slot->active_window);
+            window = slot->window[active_window];
+            _ANALOG_compiler_barrier();
+        }
+        while (sequence != analog_ctx.statistics_sequence);
+    }
+    // Compute statistics.
+    statistics->start_time_us = window.start_time_us;
+    statistics->number_of_samples = window.number_of_samples;
+    statistics->min = 0;
+    statistics->max = 0;
+    statistics->mean = 0;
+    statistics->variance = 0;
+    statistics->rms = 0;
+    if (window.number_of_samples == 0) goto errors;
+    mean_deviation = (window.sum / ((int64_t) window.number_of_samples));
+    mean_square_deviation = ((window.sum_of_squares / ((uint64_t) window.number_of_samples)) << (window.square_shift << 1));
+    statistics->min = window.min;
+    statistics->max = window.max;
+    statistics->mean = (int32_t) (window.offset + mean_deviation);
+    // Var(X) = E[(X - offset)^2] - (E[X] - offset)^2.
+    if (mean_square_deviation > ((uint64_t) (mean_deviation * mean_deviation))) {
+        statistics->variance = mean_square_deviation - ((uint64_t) (mean_deviation * mean_deviation));
+    }
+    // RMS^2 = E[X]^2 + Var(X).
+    statistics->rms = ANALOG_MATHS_sqrt((uint64_t) (((int64_t) statistics->mean) * ((int64_t) statistics->mean)) + statistics->variance);
+errors:
+    return status;
+}
+
+/*******************************************************************/
+ANALOG_status_t ANALOG_reset_output_current_quantiles(void) {
+    // Local variables.
+    ANALOG_status_t status = ANALOG_SUCCESS;
+    // Histogram is only written under interrupt.
+    analog_ctx.quantile_reset_request = 1;
+    return status;
+}
+
+/*******************************************************************/
+ANALOG_status_t ANALOG_read_output_current_quantile(uint16_t quantile_permille, int32_t* output_current_ua, uint32_t* number_of_samples) {
+    // Local variables.
+    ANALOG_status_t status = ANALOG_SUCCESS;
+    uint64_t total_count = 0;
+    uint64_t cumulative_count = 0;
+    uint64_t rank = 0;
+    uint32_t mantissa = 0;
+    uint8_t shift = 0;
+    uint16_t bucket = 0;
+    // Check parameters.
+    if (quantile_permille > ANALOG_QUANTILE_PERMILLE_MAX) {
+        status = ANALOG_ERROR_QUANTILE;
+        goto errors;
+    }
+    if ((output_current_ua == NULL) || (number_of_samples == NULL)) {
+        status = ANALOG_ERROR_NULL_PARAMETER;
+        goto errors;
+    }
+    (*number_of_samples) = analog_ctx.quantile_number_of_samples;
+    // Count samples (histogram may have been rescaled).
+    for (bucket = 0; bucket < ANALOG_QUANTILE_NUMBER_OF_BUCKETS; bucket++) {
+        total_count += analog_ctx.quantile_histogram[bucket];
+    }
+    if (total_count == 0) {
+        status = ANALOG_ERROR_QUANTILE_NO_SAMPLE;
+        goto errors;
+    }
+    // Search the bucket containing the requested rank.
+    rank = ((total_count * quantile_permille) + ANALOG_QUANTILE_PERMILLE_MAX - 1) / ANALOG_QUANTILE_PERMILLE_MAX;
+    if (rank == 0) {
+        rank = 1;
+    }
+    for (bucket = 0; bucket < (ANALOG_QUANTILE_NUMBER_OF_BUCKETS - 1); bucket++) {
+        cumulative_count += analog_ctx.quantile_histogram[bucket];
+        if (cumulative_count >= rank) break;
+    }
+    // Return bucket center.
+    if (bucket >= ANALOG_QUANTILE_SUB_BUCKETS) {
+        shift = (uint8_t) ((bucket >> ANALOG_QUANTILE_SUB_BUCKET_BITS) - 1);
+        mantissa = (uint32_t) (ANALOG_QUANTILE_SUB_BUCKETS + (bucket & (ANALOG_QUANTILE_SUB_BUCKETS - 1)));
+        (*output_current_ua) = (int32_t) ((mantissa << shift) + ((((uint32_t) 0b1) << shift) >> 1));
+    }
+    else {
+        (*output_current_ua) = (int32_t) bucket;
+    }
+errors:
+    return status;
+}
+
+/*******************************************************************/
+ANALOG_status_t ANALOG_set_spectrum_bin(uint8_t bin_index, uint16_t frequency_hz) {
+    // Local variables.
+    ANALOG_status_t status = ANALOG_SUCCESS;
+    ANALOG_spectrum_bin_t* bin = NULL;
+    uint32_t phase = 0;
+    // Check parameters.
+    if (bin_index >= ANALOG_SPECTRUM_NUMBER_OF_BINS) {
+        status = ANALOG_ERROR_SPECTRUM_BIN;
+        goto errors;
+    }
+    if ((frequency_hz != 0) && ((frequency_hz < ANALOG_SPECTRUM_FREQUENCY_MIN_HZ) || (frequency_hz > ANALOG_SPECTRUM_FREQUENCY_MAX_HZ))) {
+        status = ANALOG_ERROR_SPECTRUM_FREQUENCY;
+        goto errors;
+    }
+    bin = &(analog_ctx.spectrum[bin_index]);
+    // Disable bin during update.
+    bin->enable = 0;
+    bin->active = 0;
+    bin->amplitude_mv = ANALOG_ERROR_VALUE;
+    bin->frequency_hz = frequency_hz;
+    if (frequency_hz == 0) goto errors;
+    // Goertzel coefficient 2cos(2 * pi * f / fs).
+    phase = (uint32_t) ((((uint64_t) frequency_hz) << ANALOG_SPECTRUM_PHASE_BITS) / ANALOG_SPECTRUM_SAMPLING_FREQUENCY_HZ);
+    bin->coefficient = (_ANALOG_cosine(phase) >> (ANALOG_SPECTRUM_FRACTIONAL_BITS - ANALOG_SPECTRUM_COEFFICIENT_BITS - 1));
+    bin->enable = 1;
+errors:
+    return status;
+}
+
+/*******************************************************************/
+ANALOG_status_t ANALOG_read_spectrum_bin(uint8_t bin_index, uint16_t* frequency_hz, int32_t* amplitude_mv) {
+    // Local variables.
+    ANALOG_status_t status = ANALOG_SUCCESS;
+    // Check parameters.
+    if (bin_index >= ANALOG_SPECTRUM_NUMBER_OF_BINS) {
+        status = ANALOG_ERROR_SPECTRUM_BIN;
+        goto errors;
+    }
+    if ((frequency_hz == NULL) || (amplitude_mv == NULL)) {
+        status = ANALOG_ERROR_NULL_PARAMETER;
+        goto errors;
+    }
+    (*frequency_hz) = analog_ctx.spectrum[bin_index].frequency_hz;
+    (*amplitude_mv) = analog_ctx.spectrum[bin_index].amplitude_mv;
+errors:
+    return status;
+}
+
+/*******************************************************************/
+ANALOG_status_t ANALOG_get_journal_sequence(uint32_t* sequence) {
+    // Local variables.
+    ANALOG_status_t status = ANALOG_SUCCESS;
+    // Check parameter.
+    if (sequence == NULL) {
+        status = ANALOG_ERROR_NULL_PARAMETER;
+        goto errors;
+    }
+    (*sequence) = analog_ctx.journal_sequence;
+errors:
+    return status;
+}
+
+/*******************************************************************/
+ANALOG_status_t ANALOG_read_journal_entry(uint32_t sequence, ANALOG_journal_entry_t* journal_entry) {
+    // Local variables.
+    ANALOG_status_t status = ANALOG_SUCCESS;
+    ANALOG_journal_record_t* record = &(analog_ctx.journal[sequence & ANALOG_JOURNAL_INDEX_MASK]);
+    // Check parameters.
+    if (journal_entry == NULL) {
+        status = ANALOG_ERROR_NULL_PARAMETER;
+        goto errors;
+    }
+    if (((analog_ctx.journal_sequence - sequence) - 1) >= ANALOG_JOURNAL_DEPTH) {
+        status = ANALOG_ERROR_JOURNAL_SEQUENCE;
+        goto errors;
+    }
+    // Copy record.
+    journal_entry->timestamp_us = record->timestamp_us;
+    journal_entry->event = (ANALOG_journal_event_t) (record->event);
+    journal_entry->output_current_range = (ANALOG_output_current_range_t) (record->output_current_range);
+    journal_entry->output_current_ua = record->output_current_ua;
+    // Check that the record has not been overwritten during the copy.
+    if ((analog_ctx.journal_sequence - sequence) > ANALOG_JOURNAL_DEPTH) {
+        status = ANALOG_ERROR_JOURNAL_SEQUENCE;
+        goto errors;
+    }
+errors:
+    return status;
+}
+
+/*******************************************************************/
+ANALOG_status_t ANALOG_set_alarm(ANALOG_alarm_t alarm, int32_t threshold) {
+    // Local variables.
+    ANALOG_status_t status = ANALOG_SUCCESS;
+    // Check parameters.
+    if (alarm >= ANALOG_ALARM_LAST) {
+        status = ANALOG_ERROR_ALARM;
+        goto errors;
+    }
+    if (threshold <= 0) {
+        status = ANALOG_ERROR_ALARM_THRESHOLD;
+        goto errors;
+    }
+    // Update configuration.
+    analog_ctx.alarms[alarm].threshold = threshold;
+    analog_ctx.alarms[alarm].enable = 1;
+    _ANALOG_update_watchdog();
+    _ANALOG_update_output_current_watchdog();
+errors:
+    return status;
+}
+
+/*******************************************************************/
+ANALOG_status_t ANALOG_disable_alarm(ANALOG_alarm_t alarm) {
+    // Local variables.
+    ANALOG_status_t status = ANALOG_SUCCESS;
+    // Check parameter.
+    if (alarm >= ANALOG_ALARM_LAST) {
+        status = ANALOG_ERROR_ALARM;
+        goto errors;
+    }
+    // Update configuration.
+    analog_ctx.alarms[alarm].enable = 0;
+    _ANALOG_update_watchdog();
+    _ANALOG_update_output_current_watchdog();
+errors:
+    return status;
+}
+
+/*******************************************************************/
+ANALOG_status_t ANALOG_acknowledge_alarm(ANALOG_alarm_t alarm) {
+    // Local variables.
+    ANALOG_status_t status = ANALOG_SUCCESS;
+    // Check parameter.
+    if (alarm >= ANALOG_ALARM_LAST) {
+        status = ANALOG_ERROR_ALARM;
+        goto errors;
+    }
+    // Clear event and re-arm.
+    analog_ctx.alarms[alarm].notified = 0;
+    analog_ctx.alarms[alarm].latched = 0;
+    _ANALOG_update_watchdog();
+    _ANALOG_update_output_current_watchdog();
+errors:
+    return status;
+}
+
+/*******************************************************************/
+ANALOG_status_t ANALOG_get_alarm(ANALOG_alarm_t alarm, ANALOG_alarm_information_t* alarm_information) {
+    // Local variables.
+    ANALOG_status_t status = ANALOG_SUCCESS;
+    // Check parameters.
+    if (alarm >= ANALOG_ALARM_LAST) {
+        status = ANALOG_ERROR_ALARM;
+        goto errors;
+    }
+    if (alarm_information == NULL) {
+        status = ANALOG_ERROR_NULL_PARAMETER;
+        goto errors;
+    }
+    // Copy alarm (event fields are stable once latched).
+    alarm_information->enable = analog_ctx.alarms[alarm].enable;
+    alarm_information->threshold = analog_ctx.alarms[alarm].threshold;
+    alarm_information->latched = analog_ctx.alarms[alarm].latched;
+    alarm_information->timestamp_us = analog_ctx.alarms[alarm].timestamp_us;
+    alarm_information->value = analog_ctx.alarms[alarm].value;
+errors:
+    return status;
+}
+
+/*******************************************************************/
+ANALOG_status_t ANALOG_register_alarm_callback(ANALOG_alarm_cb_t alarm_callback) {
+    // Local variables.
+    ANALOG_status_t status = ANALOG_ERROR_SUBSCRIPTION_FULL;
+    uint8_t idx = 0;
+    // Check parameter.
+    if (alarm_callback == NULL) {
+        status = ANALOG_ERROR_NULL_PARAMETER;
+        goto errors;
+    }
+    // Search free slot.
+    for (idx = 0; idx < ANALOG_ALARM_CALLBACKS_MAX; idx++) {
+        if (analog_ctx.alarm_callbacks[idx] == NULL) {
+            analog_ctx.alarm_callbacks[idx] = alarm_callback;
+            status = ANALOG_SUCCESS;
+            break;
+        }
+    }
+errors:
+    return status;
+}
+
+/*******************************************************************/
+ANALOG_status_t ANALOG_unregister_alarm_callback(ANALOG_alarm_cb_t alarm_callback) {
+    // Local variables.
+    ANALOG_status_t status = ANALOG_ERROR_SUBSCRIPTION_NOT_FOUND;
+    uint8_t idx = 0;
+    // Check parameter.
+    if (alarm_callback == NULL) {
+        status = ANALOG_ERROR_NULL_PARAMETER;
+        goto errors;
+    }
+    // Search callback.
+    for (idx = 0; idx < ANALOG_ALARM_CALLBACKS_MAX; idx++) {
+        if (analog_ctx.alarm_callbacks[idx] == alarm_callback) {
+            analog_ctx.alarm_callbacks[idx] = NULL;
+            status = ANALOG_SUCCESS;
+            break;
+        }
+    }
+errors:
+    return status;
+}
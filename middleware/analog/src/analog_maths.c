@@ -0,0 +1,76 @@
+/*
+ * analog_maths.c
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "analog_maths.h"
+
+#include "types.h"
+
+/*** ANALOG MATHS functions ***/
+
+/*******************************************************************/
+uint8_t ANALOG_MATHS_get_bit_length(uint32_t value) {
+    // Local variables.
+    uint8_t bit_length = 0;
+    // Count significant bits.
+    while (value != 0) {
+        value >>= 1;
+        bit_length++;
+    }
+    return bit_length;
+}
+
+/*******************************************************************/
+void ANALOG_MATHS_compute_reciprocal(uint32_t divisor, uint32_t dividend_max, ANALOG_MATHS_reciprocal_t* reciprocal) {
+    // Local variables.
+    uint64_t numerator = 0;
+    // With S = bitlen(dividend_max) + bitlen(divisor) and M = ceil(2^S / divisor), (x * M) >> S equals x / divisor for any x <= dividend_max.
+    reciprocal->shift = (uint8_t) (ANALOG_MATHS_get_bit_length(dividend_max) + ANALOG_MATHS_get_bit_length(divisor));
+    numerator = (((uint64_t) 1) << (reciprocal->shift));
+    reciprocal->multiplier = (uint32_t) ((numerator + ((uint64_t) divisor) - 1) / ((uint64_t) divisor));
+}
+
+/*******************************************************************/
+uint32_t ANALOG_MATHS_divide(uint32_t dividend, ANALOG_MATHS_reciprocal_t* reciprocal) {
+    // Multiply by reciprocal.
+    return (uint32_t) ((((uint64_t) dividend) * ((uint64_t) (reciprocal->multiplier))) >> (reciprocal->shift));
+}
+
+/*******************************************************************/
+int32_t ANALOG_MATHS_divide_signed(int32_t dividend, ANALOG_MATHS_reciprocal_t* reciprocal) {
+    // Local variables.
+    int32_t quotient = 0;
+    // Divide absolute value to round toward zero.
+    if (dividend >= 0) {
+        quotient = (int32_t) ANALOG_MATHS_divide((uint32_t) dividend, reciprocal);
+    }
+    else {
+        quotient = -((int32_t) ANALOG_MATHS_divide((uint32_t) (-dividend), reciprocal));
+    }
+    return quotient;
+}
+
+/*******************************************************************/
+uint32_t ANALOG_MATHS_sqrt(uint64_t value) {
+    // Local variables.
+    uint64_t result = 0;
+    uint64_t bit = (((uint64_t) 1) << 62);
+    // Bit by bit integer square root.
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= (result + bit)) {
+            value -= (result + bit);
+            result = (result >> 1) + bit;
+        }
+        else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return ((uint32_t) result);
+}
@@ -0,0 +1,125 @@
+/*
+ * event.h
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef __EVENT_H__
+#define __EVENT_H__
+
+#include "error.h"
+#include "types.h"
+
+/*** EVENT structures ***/
+
+/*!******************************************************************
+ * \enum EVENT_status_t
+ * \brief EVENT driver error codes.
+ *******************************************************************/
+typedef enum {
+    // Driver errors.
+    EVENT_SUCCESS = 0,
+    EVENT_ERROR_NULL_PARAMETER,
+    EVENT_ERROR_ID,
+    // Last base value.
+    EVENT_ERROR_BASE_LAST = ERROR_BASE_STEP
+} EVENT_status_t;
+
+/*!******************************************************************
+ * \enum EVENT_t
+ * \brief Deferred events list (each event must be posted from a single interrupt).
+ *******************************************************************/
+typedef enum {
+    EVENT_TRCS_PROCESS = 0,
+    EVENT_ANALOG_WATCHDOG,
+    EVENT_ANALOG_ALARM,
+    EVENT_TIMER_PROCESS,
+    EVENT_SERIAL_COMMAND,
+    EVENT_SERIAL_DATA_READY,
+    EVENT_POWER_SUPPLY_CHECK,
+    EVENT_LAST
+} EVENT_t;
+
+/*!******************************************************************
+ * \fn EVENT_handler_cb_t
+ * \brief Event handler (called from main loop).
+ *******************************************************************/
+typedef void (*EVENT_handler_cb_t)(void);
+
+/*** EVENT functions ***/
+
+/*!******************************************************************
+ * \fn void EVENT_init(void)
+ * \brief Init deferred events driver.
+ * \param[in]   none
+ * \param[out]  none
+ * \retval      none
+ *******************************************************************/
+void EVENT_init(void);
+
+/*!******************************************************************
+ * \fn EVENT_status_t EVENT_register(EVENT_t event, EVENT_handler_cb_t handler)
+ * \brief Register the handler of an event.
+ * \param[in]   event: Event to handle.
+ * \param[in]   handler: Function called from main loop when the event is pending.
+ * \param[out]  none
+ * \retval      Function execution status.
+ *******************************************************************/
+EVENT_status_t EVENT_register(EVENT_t event, EVENT_handler_cb_t handler);
+
+/*!******************************************************************
+ * \fn void EVENT_post(EVENT_t event)
+ * \brief Post an event (interrupt safe).
+ * \param[in]   event: Event to post.
+ * \param[out]  none
+ * \retval      none
+ *******************************************************************/
+void EVENT_post(EVENT_t event);
+
+/*!******************************************************************
+ * \fn uint8_t EVENT_is_pending(void)
+ * \brief Check if at least one event has to be dispatched.
+ * \param[in]   none
+ * \param[out]  none
+ * \retval      0 if no event is pending, 1 otherwise.
+ *******************************************************************/
+uint8_t EVENT_is_pending(void);
+
+/*!******************************************************************
+ * \fn EVENT_status_t EVENT_process(void)
+ * \brief Call the handlers of all pending events.
+ * \param[in]   none
+ * \param[out]  none
+ * \retval      Function execution status.
+ *******************************************************************/
+EVENT_status_t EVENT_process(void);
+
+/*!******************************************************************
+ * \fn EVENT_status_t EVENT_get_overrun_count(EVENT_t event, uint32_t* overrun_count)
+ * \brief Get the number of posts merged because the previous one was not dispatched yet.
+ * \param[in]   event: Event to read.
+ * \param[out]  overrun_count: Pointer to integer that will contain the number of merged posts.
+ * \retval      Function execution status.
+ *******************************************************************/
+EVENT_status_t EVENT_get_overrun_count(EVENT_t event, uint32_t* overrun_count);
+
+/*!******************************************************************
+ * \fn EVENT_status_t EVENT_get_max_latency_us(EVENT_t event, uint32_t* max_latency_us)
+ * \brief Get the maximum delay between the first post of an event and its dispatch.
+ * \param[in]   event: Event to read.
+ * \param[out]  max_latency_us: Pointer to integer that will contain the maximum post to dispatch delay in us.
+ * \retval      Function execution status.
+ *******************************************************************/
+EVENT_status_t EVENT_get_max_latency_us(EVENT_t event, uint32_t* max_latency_us);
+
+/*******************************************************************/
+#define EVENT_exit_error(base) { ERROR_check_exit(event_status, EVENT_SUCCESS, base) }
+
+/*******************************************************************/
+#define EVENT_stack_error(base) { ERROR_check_stack(event_status, EVENT_SUCCESS, base) }
+
+/*******************************************************************/
+#define EVENT_stack_exit_error(base, code) { ERROR_check_stack_exit(event_status, EVENT_SUCCESS, base, code) }
+
+#endif /* __EVENT_H__ */
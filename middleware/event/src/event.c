@@ -0,0 +1,167 @@
+/*
+ * event.c
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "event.h"
+
+#include "error.h"
+#include "timer.h"
+#include "types.h"
+
+/*** EVENT local structures ***/
+
+/*******************************************************************/
+typedef struct {
+    // Only written under interrupt.
+    volatile uint8_t post_count;
+    volatile uint32_t post_time_us;
+    // Only written in main loop.
+    uint8_t dispatch_count;
+    uint32_t overrun_count;
+    uint32_t max_latency_us;
+    EVENT_handler_cb_t handler;
+} EVENT_entry_t;
+
+/*******************************************************************/
+typedef struct {
+    EVENT_entry_t entries[EVENT_LAST];
+} EVENT_context_t;
+
+/*** EVENT local global variables ***/
+
+static EVENT_context_t event_ctx;
+
+/*** EVENT functions ***/
+
+/*******************************************************************/
+void EVENT_init(void) {
+    // Local variables.
+    uint8_t idx = 0;
+    // Init context.
+    for (idx = 0; idx < EVENT_LAST; idx++) {
+        event_ctx.entries[idx].post_count = 0;
+        event_ctx.entries[idx].post_time_us = 0;
+        event_ctx.entries[idx].dispatch_count = 0;
+        event_ctx.entries[idx].overrun_count = 0;
+        event_ctx.entries[idx].max_latency_us = 0;
+        event_ctx.entries[idx].handler = NULL;
+    }
+}
+
+/*******************************************************************/
+EVENT_status_t EVENT_register(EVENT_t event, EVENT_handler_cb_t handler) {
+    // Local variables.
+    EVENT_status_t status = EVENT_SUCCESS;
+    // Check parameters.
+    if (event >= EVENT_LAST) {
+        status = EVENT_ERROR_ID;
+        goto errors;
+    }
+    if (handler == NULL) {
+        status = EVENT_ERROR_NULL_PARAMETER;
+        goto errors;
+    }
+    // Discard previous posts.
+    event_ctx.entries[event].dispatch_count = event_ctx.entries[event].post_count;
+    event_ctx.entries[event].handler = handler;
+errors:
+    return status;
+}
+
+/*******************************************************************/
+void EVENT_post(EVENT_t event) {
+    // Check parameter.
+    if (event < EVENT_LAST) {
+        // Timestamp first post only (not written again until the event is dispatched).
+        if (event_ctx.entries[event].post_count == event_ctx.entries[event].dispatch_count) {
+            event_ctx.entries[event].post_time_us = (uint32_t) TIMER_get_time_us();
+        }
+        // Single byte increment from a single interrupt context.
+        event_ctx.entries[event].post_count++;
+    }
+}
+
+/*******************************************************************/
+uint8_t EVENT_is_pending(void) {
+    // Local variables.
+    uint8_t pending = 0;
+    uint8_t idx = 0;
+    // Events loop.
+    for (idx = 0; idx < EVENT_LAST; idx++) {
+        if (event_ctx.entries[idx].post_count != event_ctx.entries[idx].dispatch_count) {
+            pending = 1;
+            break;
+        }
+    }
+    return pending;
+}
+
+/*******************************************************************/
+EVENT_status_t EVENT_process(void) {
+    // Local variables.
+    EVENT_status_t status = EVENT_SUCCESS;
+    EVENT_entry_t* entry = NULL;
+    uint32_t latency_us = 0;
+    uint8_t post_count = 0;
+    uint8_t idx = 0;
+    // Events loop.
+    for (idx = 0; idx < EVENT_LAST; idx++) {
+        entry = &(event_ctx.entries[idx]);
+        post_count = (entry->post_count);
+        // Check if event is pending.
+        if (post_count == (entry->dispatch_count)) continue;
+        // Update statistics (32-bits difference is valid across time wrapping).
+        latency_us = ((uint32_t) TIMER_get_time_us()) - (entry->post_time_us);
+        if (latency_us > (entry->max_latency_us)) {
+            entry->max_latency_us = latency_us;
+        }
+        entry->overrun_count += (uint8_t) (post_count - (entry->dispatch_count) - 1);
+        entry->dispatch_count = post_count;
+        // Call handler.
+        if ((entry->handler) == NULL) {
+            status = EVENT_ERROR_NULL_PARAMETER;
+            continue;
+        }
+        entry->handler();
+    }
+    return status;
+}
+
+/*******************************************************************/
+EVENT_status_t EVENT_get_overrun_count(EVENT_t event, uint32_t* overrun_count) {
+    // Local variables.
+    EVENT_status_t status = EVENT_SUCCESS;
+    // Check parameters.
+    if (event >= EVENT_LAST) {
+        status = EVENT_ERROR_ID;
+        goto errors;
+    }
+    if (overrun_count == NULL) {
+        status = EVENT_ERROR_NULL_PARAMETER;
+        goto errors;
+    }
+    (*overrun_count) = event_ctx.entries[event].overrun_count;
+errors:
+    return status;
+}
+
+/*******************************************************************/
+EVENT_status_t EVENT_get_max_latency_us(EVENT_t event, uint32_t* max_latency_us) {
+    // Local variables.
+    EVENT_status_t status = EVENT_SUCCESS;
+    // Check parameters.
+    if (event >= EVENT_LAST) {
+        status = EVENT_ERROR_ID;
+        goto errors;
+    }
+    if (max_latency_us == NULL) {
+        status = EVENT_ERROR_NULL_PARAMETER;
+        goto errors;
+    }
+    (*max_latency_us) = event_ctx.entries[event].max_latency_us;
+errors:
+    return status;
+}
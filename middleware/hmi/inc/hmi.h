@@ -13,7 +13,7 @@
 #include "sigfox.h"
 #include "st7066u.h"
 #include "strings.h"
-#include "tim.h"
+#include "timer.h"
 #include "types.h"
 
 /*** HMI structures ***/
@@ -28,8 +28,8 @@ typedef enum {
     HMI_ERROR_STATE,
     HMI_ERROR_UNIT_SIZE_OVERFLOW,
     // Low level drivers errors.
-    HMI_ERROR_BASE_TIM = ERROR_BASE_STEP,
-    HMI_ERROR_BASE_STRING = (HMI_ERROR_BASE_TIM + TIM_ERROR_BASE_LAST),
+    HMI_ERROR_BASE_TIMER = ERROR_BASE_STEP,
+    HMI_ERROR_BASE_STRING = (HMI_ERROR_BASE_TIMER + TIMER_ERROR_BASE_LAST),
     HMI_ERROR_BASE_ST7066U = (HMI_ERROR_BASE_STRING + STRING_ERROR_BASE_LAST),
     HMI_ERROR_BASE_SIGFOX = (HMI_ERROR_BASE_ST7066U + ST7066U_ERROR_BASE_LAST),
     HMI_ERROR_BASE_ANALOG = (HMI_ERROR_BASE_SIGFOX + SIGFOX_ERROR_BASE_LAST),
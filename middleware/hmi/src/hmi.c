@@ -11,18 +11,18 @@
 #include "error.h"
 #include "error_base.h"
 #include "maths.h"
-#include "mcu_mapping.h"
-#include "nvic_priority.h"
 #include "psfe_flags.h"
 #include "st7066u.h"
 #include "strings.h"
-#include "tim.h"
+#include "timer.h"
 #include "types.h"
 #include "version.h"
 
 /*** HMI local macros ***/
 
 #define HMI_DISPLAY_PERIOD_MS                   300
+// Output voltage is converted at 100Hz.
+#define HMI_ANALOG_DECIMATION                   30
 
 #define HMI_HW_VERSION_PRINT_DURATION_MS        2000
 #define HMI_SW_VERSION_PRINT_DURATION_MS        2000
@@ -30,6 +30,16 @@
 
 #define HMI_OUTPUT_VOLTAGE_ERROR_THRESHOLD_MV   100
 
+// Output ripple replaces output current on the second row during the last refreshes of each cycle.
+#define HMI_RIPPLE_CYCLE_REFRESHES              10
+#define HMI_RIPPLE_DISPLAY_REFRESHES            3
+
+// Display filters: spike rejection, then smoothing of the last digits while keeping fast response to load steps.
+#define HMI_FILTER_MEDIAN_TAPS                  5
+#define HMI_FILTER_TIME_CONSTANT_MS             1000
+#define HMI_FILTER_OUTPUT_VOLTAGE_STEP_MV       100
+#define HMI_FILTER_OUTPUT_CURRENT_STEP_UA       2000
+
 /*** HMI local structures ***/
 
 /*******************************************************************/
@@ -48,16 +58,21 @@ typedef enum {
 /*******************************************************************/
 typedef struct {
     HMI_state_t state;
-    volatile uint32_t uptime_ms;
-    uint32_t state_switch_time_ms;
+    TIMER_t display_timer;
+    uint64_t state_switch_time_us;
+    volatile uint8_t analog_data_ready;
+    uint8_t refresh_count;
 } HMI_context_t;
 
 /*** HMI local global variables ***/
 
+static char_t* HMI_ALARM_MESSAGE[ANALOG_ALARM_LAST] = { "ALARM V-", "ALARM V+", "ALARM I+" };
+
 static HMI_context_t hmi_ctx = {
     .state = HMI_STATE_OFF,
-    .uptime_ms = 0,
-    .state_switch_time_ms = 0
+    .state_switch_time_us = 0,
+    .analog_data_ready = 0,
+    .refresh_count = 0
 };
 
 /*** HMI local functions ***/
@@ -199,8 +214,11 @@ static HMI_status_t _HMI_process(void) {
     HMI_status_t status = HMI_SUCCESS;
     ST7066U_status_t st7066u_status = ST7066U_SUCCESS;
     ANALOG_status_t analog_status = ANALOG_SUCCESS;
+    ANALOG_snapshot_t analog_snapshot;
+    ANALOG_alarm_information_t alarm_information;
     int32_t analog_data = 0;
-    uint8_t bypass_switch_state = 0;
+    uint8_t alarm = 0;
+    uint64_t time_us = TIMER_get_time_us();
     // State machine.
     switch (hmi_ctx.state) {
     case HMI_STATE_OFF:
@@ -210,27 +228,27 @@ static HMI_status_t _HMI_process(void) {
         // Print HW version.
         _HMI_print_hw_version();
         // Update state.
-        hmi_ctx.state_switch_time_ms = hmi_ctx.uptime_ms;
+        hmi_ctx.state_switch_time_us = time_us;
         hmi_ctx.state = HMI_STATE_HW_VERSION;
         break;
     case HMI_STATE_HW_VERSION:
         // Check delay.
-        if (hmi_ctx.uptime_ms >= (hmi_ctx.state_switch_time_ms + HMI_HW_VERSION_PRINT_DURATION_MS)) {
+        if ((time_us - hmi_ctx.state_switch_time_us) >= (HMI_HW_VERSION_PRINT_DURATION_MS * 1000)) {
             // Print SW version.
             _HMI_print_sw_version();
             // Update state.
-            hmi_ctx.state_switch_time_ms = hmi_ctx.uptime_ms;
+            hmi_ctx.state_switch_time_us = time_us;
             hmi_ctx.state = HMI_STATE_SW_VERSION;
         }
         break;
     case HMI_STATE_SW_VERSION:
         // Check delay.
-        if (hmi_ctx.uptime_ms >= (hmi_ctx.state_switch_time_ms + HMI_SW_VERSION_PRINT_DURATION_MS)) {
+        if ((time_us - hmi_ctx.state_switch_time_us) >= (HMI_SW_VERSION_PRINT_DURATION_MS * 1000)) {
 #ifdef PSFE_SIGFOX_MONITORING
             // Print SW version.
             _HMI_print_sigfox_ep_id();
             // Update state.
-            hmi_ctx.state_switch_time_ms = hmi_ctx.uptime_ms;
+            hmi_ctx.state_switch_time_us = time_us;
             hmi_ctx.state = HMI_STATE_SIGFOX_EP_ID;
 #else
             hmi_ctx.state = HMI_STATE_ANALOG_DATA;
@@ -240,18 +258,21 @@ static HMI_status_t _HMI_process(void) {
 #ifdef PSFE_SIGFOX_MONITORING
     case HMI_STATE_SIGFOX_EP_ID:
         // Check delay.
-        if (hmi_ctx.uptime_ms >= (hmi_ctx.state_switch_time_ms + HMI_SIGFOX_EP_ID_PRINT_DURATION_MS)) {
+        if ((time_us - hmi_ctx.state_switch_time_us) >= (HMI_SIGFOX_EP_ID_PRINT_DURATION_MS * 1000)) {
             // Update state.
             hmi_ctx.state = HMI_STATE_ANALOG_DATA;
         }
         break;
 #endif
     case HMI_STATE_ANALOG_DATA:
-        // Read output voltage and bypass state.
-        analog_status = ANALOG_read_channel(ANALOG_CHANNEL_OUTPUT_VOLTAGE_MV, &analog_data);
-        ANALOG_exit_error(HMI_ERROR_BASE_ANALOG);
-        analog_status = ANALOG_get_bypass_switch_state(&bypass_switch_state);
+        // Refresh screen only on new data.
+        if (hmi_ctx.analog_data_ready == 0) break;
+        hmi_ctx.analog_data_ready = 0;
+        hmi_ctx.refresh_count = ((hmi_ctx.refresh_count + 1) % HMI_RIPPLE_CYCLE_REFRESHES);
+        // Read output voltage, output current and bypass state.
+        analog_status = ANALOG_read_snapshot(&analog_snapshot);
         ANALOG_exit_error(HMI_ERROR_BASE_ANALOG);
+        analog_data = analog_snapshot.filtered_data[ANALOG_CHANNEL_OUTPUT_VOLTAGE_MV];
         // Print output voltage.
         if (analog_data > HMI_OUTPUT_VOLTAGE_ERROR_THRESHOLD_MV) {
             status = _HMI_print_value(0, analog_data, 3, "V");
@@ -261,11 +282,34 @@ static HMI_status_t _HMI_process(void) {
             st7066u_status = ST7066U_print_string(0, 0, "NO INPUT");
             ST7066U_exit_error(HMI_ERROR_BASE_ST7066U);
         }
+        // Latched alarms take precedence over output current display.
+        for (alarm = 0; alarm < ANALOG_ALARM_LAST; alarm++) {
+            analog_status = ANALOG_get_alarm((ANALOG_alarm_t) alarm, &alarm_information);
+            ANALOG_exit_error(HMI_ERROR_BASE_ANALOG);
+            if (alarm_information.latched != 0) break;
+        }
+        if (alarm < ANALOG_ALARM_LAST) {
+            st7066u_status = ST7066U_print_string(1, 0, HMI_ALARM_MESSAGE[alarm]);
+            ST7066U_exit_error(HMI_ERROR_BASE_ST7066U);
+        }
+        // Check ripple display period.
+        else if ((hmi_ctx.refresh_count >= (HMI_RIPPLE_CYCLE_REFRESHES - HMI_RIPPLE_DISPLAY_REFRESHES)) && (analog_snapshot.data[ANALOG_CHANNEL_OUTPUT_RIPPLE_PEAK_TO_PEAK_MV] != ANALOG_ERROR_VALUE)) {
+            // Read output ripple.
+            analog_data = analog_snapshot.data[ANALOG_CHANNEL_OUTPUT_RIPPLE_PEAK_TO_PEAK_MV];
+            // Print output ripple.
+            if (analog_data < 1000) {
+                status = _HMI_print_value(1, analog_data, 0, "mVpp");
+                if (status != HMI_SUCCESS) goto errors;
+            }
+            else {
+                status = _HMI_print_value(1, analog_data, 3, "Vpp");
+                if (status != HMI_SUCCESS) goto errors;
+            }
+        }
         // Check bypass switch state.
-        if (bypass_switch_state == 0) {
+        else if (analog_snapshot.bypass_switch_state == 0) {
             // Read output current.
-            analog_status = ANALOG_read_channel(ANALOG_CHANNEL_OUTPUT_CURRENT_UA, &analog_data);
-            ANALOG_exit_error(HMI_ERROR_BASE_ANALOG);
+            analog_data = analog_snapshot.filtered_data[ANALOG_CHANNEL_OUTPUT_CURRENT_UA];
             // Print output current.
             if (analog_data < 1000) {
                 status = _HMI_print_value(1, analog_data, 0, "uA");
@@ -290,11 +334,19 @@ errors:
 }
 
 /*******************************************************************/
-static void _HMI_timer_irq_callback(void) {
+static void _HMI_analog_data_ready_callback(ANALOG_channel_t channel, int64_t sum, uint32_t number_of_samples) {
+    // Unused parameters.
+    UNUSED(channel);
+    UNUSED(sum);
+    UNUSED(number_of_samples);
+    // Set local flag.
+    hmi_ctx.analog_data_ready = 1;
+}
+
+/*******************************************************************/
+static void _HMI_display_timer_callback(void) {
     // Local variables.
     HMI_status_t hmi_status = HMI_SUCCESS;
-    // Set local flag.
-    hmi_ctx.uptime_ms += HMI_DISPLAY_PERIOD_MS;
     // Process HMI.
     hmi_status = _HMI_process();
     HMI_stack_error(ERROR_BASE_HMI);
@@ -307,17 +359,14 @@ HMI_status_t HMI_init(void) {
     // Local variables.
     HMI_status_t status = HMI_SUCCESS;
     ST7066U_status_t st7066u_status = ST7066U_SUCCESS;
-    TIM_status_t tim_status = TIM_SUCCESS;
     // Init context.
     hmi_ctx.state = HMI_STATE_OFF;
-    hmi_ctx.uptime_ms = 0;
-    hmi_ctx.state_switch_time_ms = 0;
+    hmi_ctx.state_switch_time_us = 0;
+    hmi_ctx.analog_data_ready = 0;
+    hmi_ctx.refresh_count = 0;
     // Init LCD driver.
     st7066u_status = ST7066U_init();
     ST7066U_exit_error(HMI_ERROR_BASE_ST7066U);
-    // Init display timer.
-    tim_status = TIM_STD_init(TIM_INSTANCE_HMI, NVIC_PRIORITY_HMI_TIMER);
-    TIM_exit_error(HMI_ERROR_BASE_TIM);
 errors:
     return status;
 }
@@ -327,10 +376,6 @@ HMI_status_t HMI_de_init(void) {
     // Local variables.
     HMI_status_t status = HMI_SUCCESS;
     ST7066U_status_t st7066u_status = ST7066U_SUCCESS;
-    TIM_status_t tim_status = TIM_SUCCESS;
-    // Release display timer.
-    tim_status = TIM_STD_de_init(TIM_INSTANCE_HMI);
-    TIM_stack_error(ERROR_BASE_HMI + HMI_ERROR_BASE_TIM);
     // Release LCD driver.
     st7066u_status = ST7066U_de_init();
     ST7066U_stack_error(ERROR_BASE_HMI + HMI_ERROR_BASE_ST7066U);
@@ -341,12 +386,28 @@ HMI_status_t HMI_de_init(void) {
 HMI_status_t HMI_start(void) {
     // Local variables.
     HMI_status_t status = HMI_SUCCESS;
-    TIM_status_t tim_status = TIM_SUCCESS;
+    ANALOG_status_t analog_status = ANALOG_SUCCESS;
+    TIMER_status_t timer_status = TIMER_SUCCESS;
+    ANALOG_filter_configuration_t filter_config;
     // Update state.
     hmi_ctx.state = HMI_STATE_INIT;
-    // Start timer.
-    tim_status = TIM_STD_start(TIM_INSTANCE_HMI, HMI_DISPLAY_PERIOD_MS, TIM_UNIT_MS, &_HMI_timer_irq_callback);
-    TIM_exit_error(HMI_ERROR_BASE_TIM);
+    hmi_ctx.analog_data_ready = 0;
+    hmi_ctx.refresh_count = 0;
+    // Configure display filters.
+    filter_config.median_taps = HMI_FILTER_MEDIAN_TAPS;
+    filter_config.time_constant_ms = HMI_FILTER_TIME_CONSTANT_MS;
+    filter_config.step_threshold = HMI_FILTER_OUTPUT_VOLTAGE_STEP_MV;
+    analog_status = ANALOG_set_filter(ANALOG_CHANNEL_OUTPUT_VOLTAGE_MV, &filter_config);
+    ANALOG_exit_error(HMI_ERROR_BASE_ANALOG);
+    filter_config.step_threshold = HMI_FILTER_OUTPUT_CURRENT_STEP_UA;
+    analog_status = ANALOG_set_filter(ANALOG_CHANNEL_OUTPUT_CURRENT_UA, &filter_config);
+    ANALOG_exit_error(HMI_ERROR_BASE_ANALOG);
+    // Register to output voltage updates.
+    analog_status = ANALOG_subscribe(ANALOG_CHANNEL_OUTPUT_VOLTAGE_MV, HMI_ANALOG_DECIMATION, &_HMI_analog_data_ready_callback);
+    ANALOG_exit_error(HMI_ERROR_BASE_ANALOG);
+    // Start display timer.
+    timer_status = TIMER_start(&(hmi_ctx.display_timer), HMI_DISPLAY_PERIOD_MS, TIMER_MODE_PERIODIC, TIMER_DISPATCH_TASK, &_HMI_display_timer_callback);
+    TIMER_exit_error(HMI_ERROR_BASE_TIMER);
 errors:
     return status;
 }
@@ -355,13 +416,17 @@ errors:
 HMI_status_t HMI_stop(void) {
     // Local variables.
     HMI_status_t status = HMI_SUCCESS;
-    TIM_status_t tim_status = TIM_SUCCESS;
+    ANALOG_status_t analog_status = ANALOG_SUCCESS;
+    TIMER_status_t timer_status = TIMER_SUCCESS;
     ST7066U_status_t st7066u_status = ST7066U_SUCCESS;
     // Update state.
     hmi_ctx.state = HMI_STATE_OFF;
-    // Stop timer.
-    tim_status = TIM_STD_stop(TIM_INSTANCE_HMI);
-    TIM_stack_error(ERROR_BASE_HMI + HMI_ERROR_BASE_TIM);
+    // Unregister from output voltage updates.
+    analog_status = ANALOG_unsubscribe(ANALOG_CHANNEL_OUTPUT_VOLTAGE_MV, &_HMI_analog_data_ready_callback);
+    ANALOG_stack_error(ERROR_BASE_HMI + HMI_ERROR_BASE_ANALOG);
+    // Stop display timer.
+    timer_status = TIMER_stop(&(hmi_ctx.display_timer));
+    TIMER_stack_error(ERROR_BASE_HMI + HMI_ERROR_BASE_TIMER);
     // Clear screen.
     st7066u_status = ST7066U_clear();
     ST7066U_stack_error(ERROR_BASE_HMI + HMI_ERROR_BASE_ST7066U);
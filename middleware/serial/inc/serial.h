@@ -10,6 +10,7 @@
 
 #include "analog.h"
 #include "error.h"
+#include "event.h"
 #include "psfe_flags.h"
 #include "terminal.h"
 #include "types.h"
@@ -26,8 +27,9 @@ typedef enum {
     // Low level drivers errors.
     SERIAL_ERROR_BASE_TERMINAL = ERROR_BASE_STEP,
     SERIAL_ERROR_BASE_ANALOG = (SERIAL_ERROR_BASE_TERMINAL + TERMINAL_ERROR_BASE_LAST),
+    SERIAL_ERROR_BASE_EVENT = (SERIAL_ERROR_BASE_ANALOG + ANALOG_ERROR_BASE_LAST),
     // Last base value.
-    SERIAL_ERROR_BASE_LAST = (SERIAL_ERROR_BASE_ANALOG + ANALOG_ERROR_BASE_LAST)
+    SERIAL_ERROR_BASE_LAST = (SERIAL_ERROR_BASE_EVENT + EVENT_ERROR_BASE_LAST)
 } SERIAL_status_t;
 
 #ifdef PSFE_SERIAL_MONITORING
@@ -70,15 +72,6 @@ SERIAL_status_t SERIAL_start(void);
  *******************************************************************/
 SERIAL_status_t SERIAL_stop(void);
 
-/*!******************************************************************
- * \fn SERIAL_status_t SERIAL_process(void)
- * \brief Process SERIAL driver.
- * \param[in]   none
- * \param[out]  none
- * \retval      Function execution status.
- *******************************************************************/
-SERIAL_status_t SERIAL_process(void);
-
 /*******************************************************************/
 #define SERIAL_exit_error(base) { ERROR_check_exit(serial_status, SERIAL_SUCCESS, base) }
 
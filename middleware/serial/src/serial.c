@@ -10,8 +10,9 @@
 #include "analog.h"
 #include "error.h"
 #include "error_base.h"
+#include "event.h"
 #include "psfe_flags.h"
-#include "rtc.h"
+#include "strings.h"
 #include "terminal.h"
 #include "terminal_instance.h"
 #include "types.h"
@@ -20,134 +21,670 @@
 
 /*** SERIAL local macros ***/
 
-#define SERIAL_PERIOD_SECONDS   1
-#define SERIAL_BAUD_RATE        9600
+// Output voltage is converted at 100Hz, output current and power at 1kHz.
+#define SERIAL_ANALOG_DECIMATION_OUTPUT_VOLTAGE     100
+#define SERIAL_ANALOG_DECIMATION_OUTPUT_CURRENT     1000
+#define SERIAL_BAUD_RATE                9600
+
+#define SERIAL_COMMAND_BUFFER_SIZE      32
+
+#define SERIAL_COMMAND_ARM              "arm"
+#define SERIAL_COMMAND_TRIGGER          "trig"
+#define SERIAL_COMMAND_DUMP             "dump"
+#define SERIAL_COMMAND_ALARM            "alarm"
+#define SERIAL_COMMAND_ACKNOWLEDGE      "ack"
+#define SERIAL_COMMAND_ENERGY           "energy"
+#define SERIAL_COMMAND_RESET            "reset"
+#define SERIAL_COMMAND_QUANTILE         "quantile"
+#define SERIAL_COMMAND_SPECTRUM         "spectrum"
+#define SERIAL_COMMAND_JOURNAL          "journal"
+#define SERIAL_COMMAND_EVENTS           "events"
 
 /*** SERIAL local structures ***/
 
 /*******************************************************************/
 typedef struct {
     uint8_t enable;
-    uint32_t next_transmission_time_seconds;
+    volatile uint8_t analog_data_ready;
+    volatile int64_t decimated_sum[ANALOG_CHANNEL_LAST];
+    volatile uint32_t decimated_number_of_samples[ANALOG_CHANNEL_LAST];
+    char_t command[SERIAL_COMMAND_BUFFER_SIZE];
+    volatile uint8_t command_size;
+    volatile uint8_t command_flag;
+    uint8_t output_current_statistics_id;
 } SERIAL_context_t;
 
 /*** SERIAL local global variables ***/
 
 static SERIAL_context_t serial_ctx = {
     .enable = 0,
-    .next_transmission_time_seconds = 0
+    .analog_data_ready = 0,
+    .decimated_sum = { [0 ... (ANALOG_CHANNEL_LAST - 1)] = 0 },
+    .decimated_number_of_samples = { [0 ... (ANALOG_CHANNEL_LAST - 1)] = 0 },
+    .command = { [0 ... (SERIAL_COMMAND_BUFFER_SIZE - 1)] = STRING_CHAR_NULL },
+    .command_size = 0,
+    .command_flag = 0,
+    .output_current_statistics_id = 0
 };
 
-/*** SERIAL functions ***/
+/*** SERIAL local functions ***/
 
 /*******************************************************************/
-SERIAL_status_t SERIAL_init(void) {
+static void _SERIAL_rx_irq_callback(uint8_t data) {
+    // Ignore characters until the current command is processed.
+    if (serial_ctx.command_flag != 0) goto errors;
+    // Check end of line.
+    if ((data == STRING_CHAR_CR) || (data == STRING_CHAR_LF)) {
+        if (serial_ctx.command_size > 0) {
+            serial_ctx.command[serial_ctx.command_size] = STRING_CHAR_NULL;
+            serial_ctx.command_flag = 1;
+            EVENT_post(EVENT_SERIAL_COMMAND);
+        }
+        goto errors;
+    }
+    // Store character.
+    if (serial_ctx.command_size < (SERIAL_COMMAND_BUFFER_SIZE - 1)) {
+        serial_ctx.command[serial_ctx.command_size] = (char_t) data;
+        serial_ctx.command_size++;
+    }
+errors:
+    return;
+}
+
+/*******************************************************************/
+static void _SERIAL_analog_data_ready_callback(ANALOG_channel_t channel, int64_t sum, uint32_t number_of_samples) {
+    // Store sum, averaged in main context.
+    serial_ctx.decimated_sum[channel] = sum;
+    serial_ctx.decimated_number_of_samples[channel] = number_of_samples;
+    // Output voltage triggers the data line (output current and power are notified first on the same scan).
+    if (channel != ANALOG_CHANNEL_OUTPUT_VOLTAGE_MV) goto errors;
+    // Set local flag.
+    serial_ctx.analog_data_ready = 1;
+    EVENT_post(EVENT_SERIAL_DATA_READY);
+errors:
+    return;
+}
+
+/*******************************************************************/
+static int32_t _SERIAL_get_decimated_data(ANALOG_channel_t channel) {
+    // Local variables.
+    int64_t sum = 0;
+    uint32_t number_of_samples = 0;
+    int32_t decimated_data = ANALOG_ERROR_VALUE;
+    // Copy sum until it was not updated during the copy.
+    do {
+        sum = serial_ctx.decimated_sum[channel];
+        number_of_samples = serial_ctx.decimated_number_of_samples[channel];
+    }
+    while ((sum != serial_ctx.decimated_sum[channel]) || (number_of_samples != serial_ctx.decimated_number_of_samples[channel]));
+    // Average valid conversions.
+    if (number_of_samples != 0) {
+        decimated_data = (int32_t) (sum / ((int64_t) number_of_samples));
+    }
+    return decimated_data;
+}
+
+/*******************************************************************/
+static uint8_t _SERIAL_parse_keyword(char_t** command, char_t* keyword) {
+    // Local variables.
+    char_t* ptr = (*command);
+    uint8_t match = 0;
+    // Compare characters.
+    while ((*keyword) != STRING_CHAR_NULL) {
+        if ((*ptr) != (*keyword)) goto errors;
+        ptr++;
+        keyword++;
+    }
+    // Keyword must be followed by a separator or the end of the command.
+    if (((*ptr) != STRING_CHAR_SPACE) && ((*ptr) != STRING_CHAR_NULL)) goto errors;
+    (*command) = ptr;
+    match = 1;
+errors:
+    return match;
+}
+
+/*******************************************************************/
+static uint8_t _SERIAL_parse_integer(char_t** command, int32_t* value) {
+    // Local variables.
+    char_t* ptr = (*command);
+    uint8_t number_of_digits = 0;
+    // Skip separators.
+    while ((*ptr) == STRING_CHAR_SPACE) {
+        ptr++;
+    }
+    // Parse decimal digits.
+    (*value) = 0;
+    while (((*ptr) >= '0') && ((*ptr) <= '9') && (number_of_digits < 9)) {
+        (*value) = ((*value) * 10) + ((*ptr) - '0');
+        number_of_digits++;
+        ptr++;
+    }
+    (*command) = ptr;
+    return ((number_of_digits > 0) ? 1 : 0);
+}
+
+/*******************************************************************/
+static SERIAL_status_t _SERIAL_send_string(char_t* str) {
     // Local variables.
     SERIAL_status_t status = SERIAL_SUCCESS;
     TERMINAL_status_t terminal_status = TERMINAL_SUCCESS;
-    // Init context.
-    serial_ctx.enable = 0;
-    serial_ctx.next_transmission_time_seconds = 0;
-    // Open terminal.
-    terminal_status = TERMINAL_open(TERMINAL_INSTANCE_SERIAL, SERIAL_BAUD_RATE, NULL);
+    // Print and send string.
+    terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, str);
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_send_tx_buffer(TERMINAL_INSTANCE_SERIAL);
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_flush_tx_buffer(TERMINAL_INSTANCE_SERIAL);
     TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
 errors:
     return status;
 }
 
 /*******************************************************************/
-SERIAL_status_t SERIAL_de_init(void) {
+static SERIAL_status_t _SERIAL_add_timestamp(uint64_t timestamp_us) {
     // Local variables.
     SERIAL_status_t status = SERIAL_SUCCESS;
     TERMINAL_status_t terminal_status = TERMINAL_SUCCESS;
-    // Close terminal.
-    terminal_status = TERMINAL_close(TERMINAL_INSTANCE_SERIAL);
-    TERMINAL_stack_error(ERROR_BASE_SERIAL + SERIAL_ERROR_BASE_TERMINAL);
+    uint32_t seconds = (uint32_t) (timestamp_us / 1000000);
+    uint32_t microseconds = (uint32_t) (timestamp_us - ((uint64_t) seconds * 1000000));
+    uint32_t digit_weight = 100000;
+    // Print seconds.
+    terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "time=");
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, (int32_t) seconds, STRING_FORMAT_DECIMAL, 0);
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, ".");
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    // Print microseconds on 6 digits.
+    while ((digit_weight > 1) && (microseconds < digit_weight)) {
+        terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "0");
+        TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+        digit_weight /= 10;
+    }
+    terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, (int32_t) microseconds, STRING_FORMAT_DECIMAL, 0);
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "s ");
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+errors:
     return status;
 }
 
 /*******************************************************************/
-SERIAL_status_t SERIAL_start(void) {
+static SERIAL_status_t _SERIAL_add_output_ripple(ANALOG_snapshot_t* analog_snapshot) {
     // Local variables.
     SERIAL_status_t status = SERIAL_SUCCESS;
     TERMINAL_status_t terminal_status = TERMINAL_SUCCESS;
-    // Update local flag.
-    serial_ctx.enable = 1;
-    // Print start message.
-    terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "SERIAL monitoring start\r\n");
+    // Check first burst.
+    if ((analog_snapshot->data[ANALOG_CHANNEL_OUTPUT_RIPPLE_RMS_MV]) == ANALOG_ERROR_VALUE) goto errors;
+    // Print peak to peak and AC RMS values.
+    terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "ripple_pp=");
     TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
-    terminal_status = TERMINAL_send_tx_buffer(TERMINAL_INSTANCE_SERIAL);
+    terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, analog_snapshot->data[ANALOG_CHANNEL_OUTPUT_RIPPLE_PEAK_TO_PEAK_MV], STRING_FORMAT_DECIMAL, 0);
     TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
-    terminal_status = TERMINAL_flush_tx_buffer(TERMINAL_INSTANCE_SERIAL);
+    terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "mV ripple_rms=");
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, analog_snapshot->data[ANALOG_CHANNEL_OUTPUT_RIPPLE_RMS_MV], STRING_FORMAT_DECIMAL, 0);
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "mV ");
     TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
 errors:
     return status;
 }
 
 /*******************************************************************/
-SERIAL_status_t SERIAL_stop(void) {
+static SERIAL_status_t _SERIAL_add_output_current_statistics(void) {
     // Local variables.
     SERIAL_status_t status = SERIAL_SUCCESS;
+    ANALOG_status_t analog_status = ANALOG_SUCCESS;
     TERMINAL_status_t terminal_status = TERMINAL_SUCCESS;
-    // Update local flag.
-    serial_ctx.enable = 0;
-    // Print stop message.
-    terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "SERIAL monitoring stop\r\n");
+    ANALOG_statistics_t analog_statistics;
+    // Read statistics since previous line.
+    analog_status = ANALOG_read_statistics(serial_ctx.output_current_statistics_id, 1, &analog_statistics);
+    ANALOG_exit_error(SERIAL_ERROR_BASE_ANALOG);
+    if (analog_statistics.number_of_samples == 0) goto errors;
+    // Print min, max and RMS.
+    terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "min=");
     TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
-    terminal_status = TERMINAL_send_tx_buffer(TERMINAL_INSTANCE_SERIAL);
+    terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, analog_statistics.min, STRING_FORMAT_DECIMAL, 0);
     TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
-    terminal_status = TERMINAL_flush_tx_buffer(TERMINAL_INSTANCE_SERIAL);
+    terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "uA max=");
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, analog_statistics.max, STRING_FORMAT_DECIMAL, 0);
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "uA rms=");
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, (int32_t) analog_statistics.rms, STRING_FORMAT_DECIMAL, 0);
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "uA ");
     TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
 errors:
     return status;
 }
 
 /*******************************************************************/
-SERIAL_status_t SERIAL_process(void) {
+static SERIAL_status_t _SERIAL_dump_capture(void) {
     // Local variables.
     SERIAL_status_t status = SERIAL_SUCCESS;
     ANALOG_status_t analog_status = ANALOG_SUCCESS;
     TERMINAL_status_t terminal_status = TERMINAL_SUCCESS;
+    ANALOG_capture_information_t capture_information;
     int32_t output_voltage_mv = 0;
+    int32_t output_current_mv = 0;
+    uint16_t idx = 0;
+    // Read capture state.
+    analog_status = ANALOG_get_capture_information(&capture_information);
+    ANALOG_exit_error(SERIAL_ERROR_BASE_ANALOG);
+    // Print header.
+    terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "capture_state=");
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, (int32_t) capture_information.state, STRING_FORMAT_DECIMAL, 0);
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, " period=");
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, (int32_t) capture_information.sampling_period_us, STRING_FORMAT_DECIMAL, 0);
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "us trigger=");
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, (int32_t) capture_information.trigger_index, STRING_FORMAT_DECIMAL, 0);
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    status = _SERIAL_send_string("\r\n");
+    if (status != SERIAL_SUCCESS) goto errors;
+    // Print samples.
+    for (idx = 0; idx < capture_information.number_of_samples; idx++) {
+        analog_status = ANALOG_read_capture_sample(idx, &output_voltage_mv, &output_current_mv);
+        ANALOG_exit_error(SERIAL_ERROR_BASE_ANALOG);
+        terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, (int32_t) idx, STRING_FORMAT_DECIMAL, 0);
+        TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+        terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, ";");
+        TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+        terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, output_voltage_mv, STRING_FORMAT_DECIMAL, 0);
+        TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+        terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, ";");
+        TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+        terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, output_current_mv, STRING_FORMAT_DECIMAL, 0);
+        TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+        status = _SERIAL_send_string("\r\n");
+        if (status != SERIAL_SUCCESS) goto errors;
+    }
+errors:
+    return status;
+}
+
+/*******************************************************************/
+static SERIAL_status_t _SERIAL_dump_journal(void) {
+    // Local variables.
+    SERIAL_status_t status = SERIAL_SUCCESS;
+    ANALOG_status_t analog_status = ANALOG_SUCCESS;
+    TERMINAL_status_t terminal_status = TERMINAL_SUCCESS;
+    ANALOG_journal_entry_t journal_entry;
+    uint32_t journal_sequence = 0;
+    uint32_t sequence = 0;
+    // Read number of events.
+    analog_status = ANALOG_get_journal_sequence(&journal_sequence);
+    ANALOG_exit_error(SERIAL_ERROR_BASE_ANALOG);
+    // Print header.
+    terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "journal_events=");
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, (int32_t) journal_sequence, STRING_FORMAT_DECIMAL, 0);
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    status = _SERIAL_send_string("\r\n");
+    if (status != SERIAL_SUCCESS) goto errors;
+    // Print kept events (sequence;time_ms;event;range;current_ua).
+    sequence = (journal_sequence > ANALOG_JOURNAL_DEPTH) ? (journal_sequence - ANALOG_JOURNAL_DEPTH) : 0;
+    for (; sequence < journal_sequence; sequence++) {
+        // Events overwritten during the dump are skipped.
+        analog_status = ANALOG_read_journal_entry(sequence, &journal_entry);
+        if (analog_status != ANALOG_SUCCESS) continue;
+        terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, (int32_t) sequence, STRING_FORMAT_DECIMAL, 0);
+        TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+        terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, ";");
+        TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+        terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, (int32_t) (journal_entry.timestamp_us / 1000), STRING_FORMAT_DECIMAL, 0);
+        TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+        terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, ";");
+        TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+        terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, (int32_t) journal_entry.event, STRING_FORMAT_DECIMAL, 0);
+        TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+        terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, ";");
+        TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+        terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, (int32_t) journal_entry.output_current_range, STRING_FORMAT_DECIMAL, 0);
+        TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+        terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, ";");
+        TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+        if (journal_entry.output_current_ua != ANALOG_ERROR_VALUE) {
+            terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, journal_entry.output_current_ua, STRING_FORMAT_DECIMAL, 0);
+            TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+        }
+        status = _SERIAL_send_string("\r\n");
+        if (status != SERIAL_SUCCESS) goto errors;
+    }
+    status = _SERIAL_send_string("OK\r\n");
+errors:
+    return status;
+}
+
+/*******************************************************************/
+static SERIAL_status_t _SERIAL_print_events(void) {
+    // Local variables.
+    SERIAL_status_t status = SERIAL_SUCCESS;
+    EVENT_status_t event_status = EVENT_SUCCESS;
+    TERMINAL_status_t terminal_status = TERMINAL_SUCCESS;
+    uint32_t overrun_count = 0;
+    uint32_t max_latency_us = 0;
+    uint8_t idx = 0;
+    // Print events statistics (event;overrun_count;max_latency_us).
+    for (idx = 0; idx < EVENT_LAST; idx++) {
+        event_status = EVENT_get_overrun_count((EVENT_t) idx, &overrun_count);
+        EVENT_exit_error(SERIAL_ERROR_BASE_EVENT);
+        event_status = EVENT_get_max_latency_us((EVENT_t) idx, &max_latency_us);
+        EVENT_exit_error(SERIAL_ERROR_BASE_EVENT);
+        terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, (int32_t) idx, STRING_FORMAT_DECIMAL, 0);
+        TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+        terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, ";");
+        TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+        terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, (int32_t) overrun_count, STRING_FORMAT_DECIMAL, 0);
+        TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+        terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, ";");
+        TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+        terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, (int32_t) max_latency_us, STRING_FORMAT_DECIMAL, 0);
+        TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+        status = _SERIAL_send_string("\r\n");
+        if (status != SERIAL_SUCCESS) goto errors;
+    }
+    status = _SERIAL_send_string("OK\r\n");
+errors:
+    return status;
+}
+
+/*******************************************************************/
+static SERIAL_status_t _SERIAL_print_energy(void) {
+    // Local variables.
+    SERIAL_status_t status = SERIAL_SUCCESS;
+    ANALOG_status_t analog_status = ANALOG_SUCCESS;
+    TERMINAL_status_t terminal_status = TERMINAL_SUCCESS;
+    ANALOG_energy_t energy;
+    // Read accumulators.
+    analog_status = ANALOG_read_energy(&energy);
+    ANALOG_exit_error(SERIAL_ERROR_BASE_ANALOG);
+    // Print integration time.
+    status = _SERIAL_add_timestamp(energy.duration_us);
+    if (status != SERIAL_SUCCESS) goto errors;
+    // Print charge and energy.
+    terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "output_charge=");
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, (int32_t) energy.output_charge_uah, STRING_FORMAT_DECIMAL, 0);
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "uAh output_energy=");
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, (int32_t) energy.output_energy_uwh, STRING_FORMAT_DECIMAL, 0);
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    status = _SERIAL_send_string("uWh\r\n");
+errors:
+    return status;
+}
+
+/*******************************************************************/
+static SERIAL_status_t _SERIAL_print_quantile(int32_t quantile_permille) {
+    // Local variables.
+    SERIAL_status_t status = SERIAL_SUCCESS;
+    ANALOG_status_t analog_status = ANALOG_SUCCESS;
+    TERMINAL_status_t terminal_status = TERMINAL_SUCCESS;
     int32_t output_current_ua = 0;
-    uint8_t bypass_switch_state = 0;
-    ANALOG_output_current_range_t output_current_range = ANALOG_OUTPUT_CURRENT_RANGE_NONE;
-    // Check period.
-    if ((serial_ctx.enable != 0) && (RTC_get_uptime_seconds() >= serial_ctx.next_transmission_time_seconds)) {
-        // Update next transmission time.
-        serial_ctx.next_transmission_time_seconds = (RTC_get_uptime_seconds() + SERIAL_PERIOD_SECONDS);
-        // Read analog data and state.
-        analog_status = ANALOG_read_channel(ANALOG_CHANNEL_OUTPUT_VOLTAGE_MV, &output_voltage_mv);
+    uint32_t number_of_samples = 0;
+    // Estimate quantile.
+    analog_status = ANALOG_read_output_current_quantile((uint16_t) quantile_permille, &output_current_ua, &number_of_samples);
+    if (analog_status != ANALOG_SUCCESS) {
+        // Invalid quantile or no data is not reported in the error stack.
+        status = _SERIAL_send_string("ERROR\r\n");
+        goto errors;
+    }
+    // Print result.
+    terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "quantile=");
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, quantile_permille, STRING_FORMAT_DECIMAL, 0);
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "/1000 output_current=");
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, output_current_ua, STRING_FORMAT_DECIMAL, 0);
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "uA samples=");
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, (int32_t) number_of_samples, STRING_FORMAT_DECIMAL, 0);
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    status = _SERIAL_send_string("\r\n");
+errors:
+    return status;
+}
+
+/*******************************************************************/
+static SERIAL_status_t _SERIAL_print_spectrum(void) {
+    // Local variables.
+    SERIAL_status_t status = SERIAL_SUCCESS;
+    ANALOG_status_t analog_status = ANALOG_SUCCESS;
+    TERMINAL_status_t terminal_status = TERMINAL_SUCCESS;
+    uint16_t frequency_hz = 0;
+    int32_t amplitude_mv = 0;
+    uint8_t idx = 0;
+    // Bins loop.
+    for (idx = 0; idx < ANALOG_SPECTRUM_NUMBER_OF_BINS; idx++) {
+        analog_status = ANALOG_read_spectrum_bin(idx, &frequency_hz, &amplitude_mv);
         ANALOG_exit_error(SERIAL_ERROR_BASE_ANALOG);
-        analog_status = ANALOG_read_channel(ANALOG_CHANNEL_OUTPUT_CURRENT_UA, &output_current_ua);
+        if (frequency_hz == 0) continue;
+        // Print bin.
+        terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "bin=");
+        TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+        terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, (int32_t) idx, STRING_FORMAT_DECIMAL, 0);
+        TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+        terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, " frequency=");
+        TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+        terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, (int32_t) frequency_hz, STRING_FORMAT_DECIMAL, 0);
+        TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+        terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "Hz amplitude=");
+        TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+        if (amplitude_mv != ANALOG_ERROR_VALUE) {
+            terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, amplitude_mv, STRING_FORMAT_DECIMAL, 0);
+            TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+            terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "mV\r\n");
+        }
+        else {
+            terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "N/A\r\n");
+        }
+        TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    }
+    status = _SERIAL_send_string("OK\r\n");
+errors:
+    return status;
+}
+
+/*******************************************************************/
+static SERIAL_status_t _SERIAL_print_alarm(ANALOG_alarm_t alarm) {
+    // Local variables.
+    SERIAL_status_t status = SERIAL_SUCCESS;
+    ANALOG_status_t analog_status = ANALOG_SUCCESS;
+    TERMINAL_status_t terminal_status = TERMINAL_SUCCESS;
+    ANALOG_alarm_information_t alarm_information;
+    // Read alarm event.
+    analog_status = ANALOG_get_alarm(alarm, &alarm_information);
+    ANALOG_exit_error(SERIAL_ERROR_BASE_ANALOG);
+    // Print event time.
+    status = _SERIAL_add_timestamp(alarm_information.timestamp_us);
+    if (status != SERIAL_SUCCESS) goto errors;
+    // Print alarm and measured value.
+    terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "alarm=");
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, (int32_t) alarm, STRING_FORMAT_DECIMAL, 0);
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, " value=");
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, alarm_information.value, STRING_FORMAT_DECIMAL, 0);
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    status = _SERIAL_send_string((alarm == ANALOG_ALARM_OUTPUT_CURRENT_HIGH) ? "uA\r\n" : "mV\r\n");
+errors:
+    return status;
+}
+
+/*******************************************************************/
+static void _SERIAL_alarm_callback(ANALOG_alarm_t alarm) {
+    // Local variables.
+    SERIAL_status_t serial_status = SERIAL_SUCCESS;
+    // Report alarm event.
+    serial_status = _SERIAL_print_alarm(alarm);
+    SERIAL_stack_error(ERROR_BASE_SERIAL);
+}
+
+/*******************************************************************/
+static SERIAL_status_t _SERIAL_process_command(void) {
+    // Local variables.
+    SERIAL_status_t status = SERIAL_SUCCESS;
+    ANALOG_status_t analog_status = ANALOG_ERROR_NULL_PARAMETER;
+    char_t* command = serial_ctx.command;
+    int32_t trigger = 0;
+    int32_t threshold_mv = 0;
+    int32_t pre_trigger_samples = 0;
+    int32_t alarm = 0;
+    int32_t quantile_permille = 0;
+    int32_t bin_index = 0;
+    int32_t frequency_hz = 0;
+    // Check command.
+    if (_SERIAL_parse_keyword(&command, SERIAL_COMMAND_ARM) != 0) {
+        // Parse arguments.
+        if ((_SERIAL_parse_integer(&command, &trigger) != 0) && (_SERIAL_parse_integer(&command, &threshold_mv) != 0) && (_SERIAL_parse_integer(&command, &pre_trigger_samples) != 0) && (pre_trigger_samples <= 0xFFFF)) {
+            analog_status = ANALOG_arm_capture((ANALOG_capture_trigger_t) trigger, threshold_mv, (uint16_t) pre_trigger_samples);
+        }
+    }
+    else if (_SERIAL_parse_keyword(&command, SERIAL_COMMAND_TRIGGER) != 0) {
+        analog_status = ANALOG_trigger_capture();
+    }
+    else if (_SERIAL_parse_keyword(&command, SERIAL_COMMAND_DUMP) != 0) {
+        status = _SERIAL_dump_capture();
+        goto errors;
+    }
+    else if (_SERIAL_parse_keyword(&command, SERIAL_COMMAND_ALARM) != 0) {
+        // Parse arguments (null or negative threshold disables the alarm).
+        if ((_SERIAL_parse_integer(&command, &alarm) != 0) && (_SERIAL_parse_integer(&command, &threshold_mv) != 0) && (alarm >= 0)) {
+            analog_status = (threshold_mv > 0) ? ANALOG_set_alarm((ANALOG_alarm_t) alarm, threshold_mv) : ANALOG_disable_alarm((ANALOG_alarm_t) alarm);
+        }
+    }
+    else if (_SERIAL_parse_keyword(&command, SERIAL_COMMAND_ENERGY) != 0) {
+        // Print accumulators or reset them.
+        if (_SERIAL_parse_keyword(&command, " " SERIAL_COMMAND_RESET) != 0) {
+            analog_status = ANALOG_reset_energy();
+        }
+        else {
+            status = _SERIAL_print_energy();
+            goto errors;
+        }
+    }
+    else if (_SERIAL_parse_keyword(&command, SERIAL_COMMAND_QUANTILE) != 0) {
+        // Print output current quantile or reset distribution.
+        if (_SERIAL_parse_keyword(&command, " " SERIAL_COMMAND_RESET) != 0) {
+            analog_status = ANALOG_reset_output_current_quantiles();
+        }
+        else if (_SERIAL_parse_integer(&command, &quantile_permille) != 0) {
+            status = _SERIAL_print_quantile(quantile_permille);
+            goto errors;
+        }
+    }
+    else if (_SERIAL_parse_keyword(&command, SERIAL_COMMAND_SPECTRUM) != 0) {
+        // Configure a bin (null frequency disables it) or print all bins.
+        if (_SERIAL_parse_integer(&command, &bin_index) != 0) {
+            if ((_SERIAL_parse_integer(&command, &frequency_hz) != 0) && (bin_index >= 0) && (bin_index <= 0xFF) && (frequency_hz >= 0) && (frequency_hz <= 0xFFFF)) {
+                analog_status = ANALOG_set_spectrum_bin((uint8_t) bin_index, (uint16_t) frequency_hz);
+            }
+        }
+        else {
+            status = _SERIAL_print_spectrum();
+            goto errors;
+        }
+    }
+    else if (_SERIAL_parse_keyword(&command, SERIAL_COMMAND_JOURNAL) != 0) {
+        status = _SERIAL_dump_journal();
+        goto errors;
+    }
+    else if (_SERIAL_parse_keyword(&command, SERIAL_COMMAND_EVENTS) != 0) {
+        status = _SERIAL_print_events();
+        goto errors;
+    }
+    else if (_SERIAL_parse_keyword(&command, SERIAL_COMMAND_ACKNOWLEDGE) != 0) {
+        if ((_SERIAL_parse_integer(&command, &alarm) != 0) && (alarm >= 0)) {
+            analog_status = ANALOG_acknowledge_alarm((ANALOG_alarm_t) alarm);
+        }
+    }
+    // Send reply (invalid commands are not reported in the error stack).
+    status = _SERIAL_send_string((analog_status == ANALOG_SUCCESS) ? "OK\r\n" : "ERROR\r\n");
+errors:
+    return status;
+}
+
+/*******************************************************************/
+static SERIAL_status_t _SERIAL_process(void) {
+    // Local variables.
+    SERIAL_status_t status = SERIAL_SUCCESS;
+    ANALOG_status_t analog_status = ANALOG_SUCCESS;
+    TERMINAL_status_t terminal_status = TERMINAL_SUCCESS;
+    ANALOG_snapshot_t analog_snapshot;
+    int32_t output_current_ua = 0;
+    // Check received command.
+    if (serial_ctx.command_flag != 0) {
+        // Execute command when monitoring is running.
+        if (serial_ctx.enable != 0) {
+            status = _SERIAL_process_command();
+        }
+        // Wait for next command.
+        serial_ctx.command_size = 0;
+        serial_ctx.command_flag = 0;
+        if (status != SERIAL_SUCCESS) goto errors;
+    }
+    // Check new data.
+    if ((serial_ctx.enable != 0) && (serial_ctx.analog_data_ready != 0)) {
+        // Clear flag.
+        serial_ctx.analog_data_ready = 0;
+        // Read analog data and state.
+        analog_status = ANALOG_read_snapshot(&analog_snapshot);
         ANALOG_exit_error(SERIAL_ERROR_BASE_ANALOG);
-        analog_status = ANALOG_get_bypass_switch_state(&bypass_switch_state);
-        ANALOG_exit_error(HMI_ERROR_BASE_ANALOG);
-        analog_status = ANALOG_get_output_current_range(&output_current_range);
-        ANALOG_exit_error(SIGFOX_ERROR_BASE_ANALOG);
-        // Print output voltage.
+        // Print acquisition time.
+        status = _SERIAL_add_timestamp(analog_snapshot.timestamp_us);
+        if (status != SERIAL_SUCCESS) goto errors;
+        // Print output voltage averaged over the line period.
         terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "output_voltage=");
         TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
-        terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, output_voltage_mv, STRING_FORMAT_DECIMAL, 0);
+        terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, _SERIAL_get_decimated_data(ANALOG_CHANNEL_OUTPUT_VOLTAGE_MV), STRING_FORMAT_DECIMAL, 0);
         TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
-        terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "mV output_current=");
+        terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "mV ");
         TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
-        // Print output current.
-        if (bypass_switch_state == 0) {
+        // Print output ripple of the last burst.
+        status = _SERIAL_add_output_ripple(&analog_snapshot);
+        if (status != SERIAL_SUCCESS) goto errors;
+        terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "output_current=");
+        TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+        // Print output current and power averaged over the line period.
+        output_current_ua = _SERIAL_get_decimated_data(ANALOG_CHANNEL_OUTPUT_CURRENT_UA);
+        if ((analog_snapshot.bypass_switch_state == 0) && (output_current_ua != ANALOG_ERROR_VALUE)) {
             terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, output_current_ua, STRING_FORMAT_DECIMAL, 0);
             TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
-            terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "uA ");
+            terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "uA output_power=");
+            TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+            terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, _SERIAL_get_decimated_data(ANALOG_CHANNEL_OUTPUT_POWER_UW), STRING_FORMAT_DECIMAL, 0);
+            TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+            terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "uW ");
             TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
         }
         else {
             terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "N/A ");
             TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
         }
+        // Print output current statistics over the line period.
+        status = _SERIAL_add_output_current_statistics();
+        if (status != SERIAL_SUCCESS) goto errors;
         // Print range.
         terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "Range=");
         TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
-        terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, (int32_t) output_current_range, STRING_FORMAT_DECIMAL, 0);
+        terminal_status = TERMINAL_tx_buffer_add_integer(TERMINAL_INSTANCE_SERIAL, (int32_t) analog_snapshot.output_current_range, STRING_FORMAT_DECIMAL, 0);
         TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+        // Flag held output current values.
+        if (analog_snapshot.output_current_valid == 0) {
+            terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, " settling");
+            TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+        }
         terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "\r\n");
         TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
         // Send serial message.
@@ -160,4 +697,114 @@ errors:
     return status;
 }
 
+/*******************************************************************/
+static void _SERIAL_process_event_handler(void) {
+    // Local variables.
+    SERIAL_status_t serial_status = SERIAL_SUCCESS;
+    // Process serial monitoring.
+    serial_status = _SERIAL_process();
+    SERIAL_stack_error(ERROR_BASE_SERIAL);
+}
+
+/*** SERIAL functions ***/
+
+/*******************************************************************/
+SERIAL_status_t SERIAL_init(void) {
+    // Local variables.
+    SERIAL_status_t status = SERIAL_SUCCESS;
+    TERMINAL_status_t terminal_status = TERMINAL_SUCCESS;
+    EVENT_status_t event_status = EVENT_SUCCESS;
+    // Init context.
+    serial_ctx.enable = 0;
+    serial_ctx.analog_data_ready = 0;
+    serial_ctx.command_size = 0;
+    serial_ctx.command_flag = 0;
+    // Open terminal.
+    terminal_status = TERMINAL_open(TERMINAL_INSTANCE_SERIAL, SERIAL_BAUD_RATE, &_SERIAL_rx_irq_callback);
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    // Register processing.
+    event_status = EVENT_register(EVENT_SERIAL_COMMAND, &_SERIAL_process_event_handler);
+    EVENT_exit_error(SERIAL_ERROR_BASE_EVENT);
+    event_status = EVENT_register(EVENT_SERIAL_DATA_READY, &_SERIAL_process_event_handler);
+    EVENT_exit_error(SERIAL_ERROR_BASE_EVENT);
+errors:
+    return status;
+}
+
+/*******************************************************************/
+SERIAL_status_t SERIAL_de_init(void) {
+    // Local variables.
+    SERIAL_status_t status = SERIAL_SUCCESS;
+    TERMINAL_status_t terminal_status = TERMINAL_SUCCESS;
+    // Close terminal.
+    terminal_status = TERMINAL_close(TERMINAL_INSTANCE_SERIAL);
+    TERMINAL_stack_error(ERROR_BASE_SERIAL + SERIAL_ERROR_BASE_TERMINAL);
+    return status;
+}
+
+/*******************************************************************/
+SERIAL_status_t SERIAL_start(void) {
+    // Local variables.
+    SERIAL_status_t status = SERIAL_SUCCESS;
+    ANALOG_status_t analog_status = ANALOG_SUCCESS;
+    TERMINAL_status_t terminal_status = TERMINAL_SUCCESS;
+    // Update local flag.
+    serial_ctx.enable = 1;
+    serial_ctx.analog_data_ready = 0;
+    // Register to output channels averaged updates.
+    analog_status = ANALOG_subscribe(ANALOG_CHANNEL_OUTPUT_CURRENT_UA, SERIAL_ANALOG_DECIMATION_OUTPUT_CURRENT, &_SERIAL_analog_data_ready_callback);
+    ANALOG_exit_error(SERIAL_ERROR_BASE_ANALOG);
+    analog_status = ANALOG_subscribe(ANALOG_CHANNEL_OUTPUT_POWER_UW, SERIAL_ANALOG_DECIMATION_OUTPUT_CURRENT, &_SERIAL_analog_data_ready_callback);
+    ANALOG_exit_error(SERIAL_ERROR_BASE_ANALOG);
+    analog_status = ANALOG_subscribe(ANALOG_CHANNEL_OUTPUT_VOLTAGE_MV, SERIAL_ANALOG_DECIMATION_OUTPUT_VOLTAGE, &_SERIAL_analog_data_ready_callback);
+    ANALOG_exit_error(SERIAL_ERROR_BASE_ANALOG);
+    // Register to alarm events.
+    analog_status = ANALOG_register_alarm_callback(&_SERIAL_alarm_callback);
+    ANALOG_exit_error(SERIAL_ERROR_BASE_ANALOG);
+    // Start output current statistics.
+    analog_status = ANALOG_open_statistics(ANALOG_CHANNEL_OUTPUT_CURRENT_UA, &(serial_ctx.output_current_statistics_id));
+    ANALOG_exit_error(SERIAL_ERROR_BASE_ANALOG);
+    // Print start message.
+    terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "SERIAL monitoring start\r\n");
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_send_tx_buffer(TERMINAL_INSTANCE_SERIAL);
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_flush_tx_buffer(TERMINAL_INSTANCE_SERIAL);
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+errors:
+    return status;
+}
+
+/*******************************************************************/
+SERIAL_status_t SERIAL_stop(void) {
+    // Local variables.
+    SERIAL_status_t status = SERIAL_SUCCESS;
+    ANALOG_status_t analog_status = ANALOG_SUCCESS;
+    TERMINAL_status_t terminal_status = TERMINAL_SUCCESS;
+    // Update local flag.
+    serial_ctx.enable = 0;
+    // Unregister from output channels updates.
+    analog_status = ANALOG_unsubscribe(ANALOG_CHANNEL_OUTPUT_VOLTAGE_MV, &_SERIAL_analog_data_ready_callback);
+    ANALOG_exit_error(SERIAL_ERROR_BASE_ANALOG);
+    analog_status = ANALOG_unsubscribe(ANALOG_CHANNEL_OUTPUT_CURRENT_UA, &_SERIAL_analog_data_ready_callback);
+    ANALOG_exit_error(SERIAL_ERROR_BASE_ANALOG);
+    analog_status = ANALOG_unsubscribe(ANALOG_CHANNEL_OUTPUT_POWER_UW, &_SERIAL_analog_data_ready_callback);
+    ANALOG_exit_error(SERIAL_ERROR_BASE_ANALOG);
+    // Unregister from alarm events.
+    analog_status = ANALOG_unregister_alarm_callback(&_SERIAL_alarm_callback);
+    ANALOG_exit_error(SERIAL_ERROR_BASE_ANALOG);
+    // Stop output current statistics.
+    analog_status = ANALOG_close_statistics(serial_ctx.output_current_statistics_id);
+    ANALOG_exit_error(SERIAL_ERROR_BASE_ANALOG);
+    // Print stop message.
+    terminal_status = TERMINAL_tx_buffer_add_string(TERMINAL_INSTANCE_SERIAL, "SERIAL monitoring stop\r\n");
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_send_tx_buffer(TERMINAL_INSTANCE_SERIAL);
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+    terminal_status = TERMINAL_flush_tx_buffer(TERMINAL_INSTANCE_SERIAL);
+    TERMINAL_exit_error(SERIAL_ERROR_BASE_TERMINAL);
+errors:
+    return status;
+}
+
 #endif /*** PSFE_SERIAL_MONITORING ***/
@@ -14,8 +14,8 @@
 #include "maths.h"
 #include "psfe_flags.h"
 #include "pwr.h"
-#include "rtc.h"
 #include "td1208.h"
+#include "timer.h"
 #include "types.h"
 #include "version.h"
 
@@ -23,11 +23,21 @@
 
 /*** SIGFOX local macros ***/
 
-#define SIGFOX_PERIOD_SECONDS               300
+#define SIGFOX_PERIOD_US                    300000000
 
 #define SIGFOX_UL_PAYLOAD_SIZE_STARTUP      8
 #define SIGFOX_UL_PAYLOAD_SIZE_ERROR_STACK  12
-#define SIGFOX_UL_PAYLOAD_SIZE_MONITORING   9
+#define SIGFOX_UL_PAYLOAD_SIZE_MONITORING   12
+#define SIGFOX_UL_PAYLOAD_SIZE_ALARM        7
+
+#define SIGFOX_ALARM_VALUE_MAX              0xFFFFFF
+#define SIGFOX_ALARM_TIME_SECONDS_MAX       0xFFFFFF
+
+#define SIGFOX_STATISTICS_CHANNEL_LAST      2
+
+// Mains ripple amplitudes from the default spectrum bins (100Hz and 120Hz).
+#define SIGFOX_MAINS_RIPPLE_BIN_LAST        2
+#define SIGFOX_MAINS_RIPPLE_MV_MAX          0xFFF
 
 /*** SIGFOX local structures ***/
 
@@ -53,9 +63,21 @@ typedef union {
         unsigned output_current_ua :24;
         unsigned mcu_voltage_mv :16;
         unsigned mcu_temperature_degrees :8;
+        unsigned mains_ripple_100hz_mv :12;
+        unsigned mains_ripple_120hz_mv :12;
     } __attribute__((scalar_storage_order("big-endian"))) __attribute__((packed));
 } SIGFOX_ul_payload_monitoring_t;
 
+/*******************************************************************/
+typedef union {
+    uint8_t frame[SIGFOX_UL_PAYLOAD_SIZE_ALARM];
+    struct {
+        unsigned alarm :8;
+        unsigned value :24;
+        unsigned time_seconds :24;
+    } __attribute__((scalar_storage_order("big-endian"))) __attribute__((packed));
+} SIGFOX_ul_payload_alarm_t;
+
 /*******************************************************************/
 typedef union {
     uint8_t all;
@@ -70,18 +92,69 @@ typedef union {
 /*******************************************************************/
 typedef struct {
     SIGFOX_flags_t flags;
-    uint32_t next_transmission_time_seconds;
+    uint64_t next_transmission_time_us;
+    uint8_t alarm_pending_mask;
+    uint8_t statistics_id[SIGFOX_STATISTICS_CHANNEL_LAST];
     uint8_t ep_id[TD1208_SIGFOX_EP_ID_SIZE_BYTES];
 } SIGFOX_context_t;
 
 /*** SIGFOX local global variables ***/
 
+// Channels averaged over the transmission period.
+static const ANALOG_channel_t SIGFOX_STATISTICS_CHANNEL[SIGFOX_STATISTICS_CHANNEL_LAST] = {
+    ANALOG_CHANNEL_OUTPUT_VOLTAGE_MV,
+    ANALOG_CHANNEL_OUTPUT_CURRENT_UA
+};
+
 static SIGFOX_context_t sigfox_ctx = {
     .flags.all = 0,
-    .next_transmission_time_seconds = 0,
+    .next_transmission_time_us = 0,
+    .alarm_pending_mask = 0,
+    .statistics_id = { [0 ... (SIGFOX_STATISTICS_CHANNEL_LAST - 1)] = 0 },
     .ep_id = { [0 ... (TD1208_SIGFOX_EP_ID_SIZE_BYTES - 1)] = 0x00 }
 };
 
+/*** SIGFOX local functions ***/
+
+/*******************************************************************/
+static void _SIGFOX_alarm_callback(ANALOG_alarm_t alarm) {
+    // Alarm frame is sent on next process call.
+    sigfox_ctx.alarm_pending_mask |= (0b1 << alarm);
+}
+
+/*******************************************************************/
+static SIGFOX_status_t _SIGFOX_send_alarms(void) {
+    // Local variables.
+    SIGFOX_status_t status = SIGFOX_SUCCESS;
+    TD1208_status_t td1208_status = TD1208_SUCCESS;
+    ANALOG_status_t analog_status = ANALOG_SUCCESS;
+    SIGFOX_ul_payload_alarm_t sigfox_ul_payload_alarm;
+    ANALOG_alarm_information_t alarm_information;
+    uint64_t time_seconds = 0;
+    uint8_t alarm = 0;
+    // Alarms loop.
+    for (alarm = 0; alarm < ANALOG_ALARM_LAST; alarm++) {
+        // Check pending flag.
+        if ((sigfox_ctx.alarm_pending_mask & (0b1 << alarm)) == 0) continue;
+        sigfox_ctx.alarm_pending_mask &= ~(0b1 << alarm);
+        // Read alarm event.
+        analog_status = ANALOG_get_alarm((ANALOG_alarm_t) alarm, &alarm_information);
+        ANALOG_exit_error(SIGFOX_ERROR_BASE_ANALOG);
+        // Build alarm frame.
+        time_seconds = (alarm_information.timestamp_us / 1000000);
+        sigfox_ul_payload_alarm.alarm = alarm;
+        sigfox_ul_payload_alarm.value = (alarm_information.value > SIGFOX_ALARM_VALUE_MAX) ? SIGFOX_ALARM_VALUE_MAX : ((uint32_t) alarm_information.value);
+        sigfox_ul_payload_alarm.time_seconds = (time_seconds > SIGFOX_ALARM_TIME_SECONDS_MAX) ? SIGFOX_ALARM_TIME_SECONDS_MAX : ((uint32_t) time_seconds);
+        // Send alarm frame.
+        td1208_status = TD1208_send_frame(sigfox_ul_payload_alarm.frame, SIGFOX_UL_PAYLOAD_SIZE_ALARM);
+        TD1208_exit_error(SIGFOX_ERROR_BASE_TD1208);
+        // Reload watchdog.
+        IWDG_reload();
+    }
+errors:
+    return status;
+}
+
 /*** SIGFOX functions ***/
 
 /*******************************************************************/
@@ -90,7 +163,8 @@ SIGFOX_status_t SIGFOX_init(void) {
     SIGFOX_status_t status = SIGFOX_SUCCESS;
     TD1208_status_t td1208_status = TD1208_SUCCESS;
     // Init context.
-    sigfox_ctx.next_transmission_time_seconds = 0;
+    sigfox_ctx.next_transmission_time_us = 0;
+    sigfox_ctx.alarm_pending_mask = 0;
     // Init TD1208.
     td1208_status = TD1208_init();
     TD1208_exit_error(SIGFOX_ERROR_BASE_TD1208);
@@ -121,8 +195,19 @@ SIGFOX_status_t SIGFOX_start(void) {
     // Local variables.
     SIGFOX_status_t status = SIGFOX_SUCCESS;
     TD1208_status_t td1208_status = TD1208_SUCCESS;
+    ANALOG_status_t analog_status = ANALOG_SUCCESS;
+    uint8_t idx = 0;
     // Update local flag.
     sigfox_ctx.flags.enable = 1;
+    sigfox_ctx.alarm_pending_mask = 0;
+    // Register to alarm events.
+    analog_status = ANALOG_register_alarm_callback(&_SIGFOX_alarm_callback);
+    ANALOG_exit_error(SIGFOX_ERROR_BASE_ANALOG);
+    // Start averaging output channels.
+    for (idx = 0; idx < SIGFOX_STATISTICS_CHANNEL_LAST; idx++) {
+        analog_status = ANALOG_open_statistics(SIGFOX_STATISTICS_CHANNEL[idx], &(sigfox_ctx.statistics_id[idx]));
+        ANALOG_exit_error(SIGFOX_ERROR_BASE_ANALOG);
+    }
     // Send start frame.
     td1208_status = TD1208_send_bit(1);
     TD1208_exit_error(SIGFOX_ERROR_BASE_TD1208);
@@ -137,8 +222,18 @@ SIGFOX_status_t SIGFOX_stop(void) {
     // Local variables.
     SIGFOX_status_t status = SIGFOX_SUCCESS;
     TD1208_status_t td1208_status = TD1208_SUCCESS;
+    ANALOG_status_t analog_status = ANALOG_SUCCESS;
+    uint8_t idx = 0;
     // Update local flag.
     sigfox_ctx.flags.enable = 0;
+    // Unregister from alarm events.
+    analog_status = ANALOG_unregister_alarm_callback(&_SIGFOX_alarm_callback);
+    ANALOG_exit_error(SIGFOX_ERROR_BASE_ANALOG);
+    // Stop averaging output channels.
+    for (idx = 0; idx < SIGFOX_STATISTICS_CHANNEL_LAST; idx++) {
+        analog_status = ANALOG_close_statistics(sigfox_ctx.statistics_id[idx]);
+        ANALOG_exit_error(SIGFOX_ERROR_BASE_ANALOG);
+    }
     // Send start frame.
     td1208_status = TD1208_send_bit(0);
     TD1208_exit_error(SIGFOX_ERROR_BASE_TD1208);
@@ -158,18 +253,23 @@ SIGFOX_status_t SIGFOX_process(void) {
     SIGFOX_ul_payload_startup_t sigfox_ul_payload_startup;
     SIGFOX_ul_payload_monitoring_t sigfox_ul_payload_monitoring;
     uint8_t error_stack_frame[SIGFOX_UL_PAYLOAD_SIZE_ERROR_STACK];
-    int32_t output_voltage_mv = 0;
-    int32_t output_current_ua = 0;
-    ANALOG_output_current_range_t output_current_range = ANALOG_OUTPUT_CURRENT_RANGE_NONE;
-    int32_t mcu_voltage_mv = 0;
-    int32_t mcu_temperature_degrees = 0;
+    ANALOG_snapshot_t analog_snapshot;
+    ANALOG_statistics_t analog_statistics;
     uint32_t mcu_temperature_degrees_signed_magnitude = 0;
+    uint32_t mains_ripple_mv[SIGFOX_MAINS_RIPPLE_BIN_LAST];
+    uint16_t frequency_hz = 0;
+    int32_t amplitude_mv = 0;
     ERROR_code_t error_code;
     uint8_t idx = 0;
+    // Send alarm events as soon as possible.
+    if ((sigfox_ctx.flags.enable != 0) && (sigfox_ctx.alarm_pending_mask != 0)) {
+        status = _SIGFOX_send_alarms();
+        if (status != SIGFOX_SUCCESS) goto errors;
+    }
     // Check period.
-    if ((sigfox_ctx.flags.enable != 0) && (RTC_get_uptime_seconds() >= sigfox_ctx.next_transmission_time_seconds)) {
+    if ((sigfox_ctx.flags.enable != 0) && (TIMER_get_time_us() >= sigfox_ctx.next_transmission_time_us)) {
         // Update next transmission time.
-        sigfox_ctx.next_transmission_time_seconds = (RTC_get_uptime_seconds() + SIGFOX_PERIOD_SECONDS);
+        sigfox_ctx.next_transmission_time_us = (TIMER_get_time_us() + SIGFOX_PERIOD_US);
         // Send startup frame is needed.
         if (sigfox_ctx.flags.sigfox_ul_payload_startup_sent == 0) {
             // Set flag.
@@ -190,25 +290,36 @@ SIGFOX_status_t SIGFOX_process(void) {
             IWDG_reload();
         }
         // Read analog data and measurement range.
-        analog_status = ANALOG_read_channel(ANALOG_CHANNEL_OUTPUT_VOLTAGE_MV, &output_voltage_mv);
-        ANALOG_exit_error(SIGFOX_ERROR_BASE_ANALOG);
-        analog_status = ANALOG_read_channel(ANALOG_CHANNEL_OUTPUT_CURRENT_UA, &output_current_ua);
-        ANALOG_exit_error(SIGFOX_ERROR_BASE_ANALOG);
-        analog_status = ANALOG_read_channel(ANALOG_CHANNEL_MCU_VOLTAGE_MV, &mcu_voltage_mv);
-        ANALOG_exit_error(SIGFOX_ERROR_BASE_ANALOG);
-        analog_status = ANALOG_read_channel(ANALOG_CHANNEL_MCU_TEMPERATURE_DEGREES, &mcu_temperature_degrees);
-        ANALOG_exit_error(SIGFOX_ERROR_BASE_ANALOG);
-        analog_status = ANALOG_get_output_current_range(&output_current_range);
+        analog_status = ANALOG_read_snapshot(&analog_snapshot);
         ANALOG_exit_error(SIGFOX_ERROR_BASE_ANALOG);
+        // Replace output instantaneous values by their average over the period.
+        for (idx = 0; idx < SIGFOX_STATISTICS_CHANNEL_LAST; idx++) {
+            analog_status = ANALOG_read_statistics(sigfox_ctx.statistics_id[idx], 1, &analog_statistics);
+            ANALOG_exit_error(SIGFOX_ERROR_BASE_ANALOG);
+            if (analog_statistics.number_of_samples != 0) {
+                analog_snapshot.data[SIGFOX_STATISTICS_CHANNEL[idx]] = analog_statistics.mean;
+            }
+        }
+        // Read mains ripple amplitudes (0 when not available).
+        for (idx = 0; idx < SIGFOX_MAINS_RIPPLE_BIN_LAST; idx++) {
+            analog_status = ANALOG_read_spectrum_bin(idx, &frequency_hz, &amplitude_mv);
+            ANALOG_exit_error(SIGFOX_ERROR_BASE_ANALOG);
+            mains_ripple_mv[idx] = 0;
+            if ((amplitude_mv != ANALOG_ERROR_VALUE) && (amplitude_mv > 0)) {
+                mains_ripple_mv[idx] = (amplitude_mv > SIGFOX_MAINS_RIPPLE_MV_MAX) ? SIGFOX_MAINS_RIPPLE_MV_MAX : ((uint32_t) amplitude_mv);
+            }
+        }
         // Convert to signed magnitude
-        math_status = MATH_integer_to_signed_magnitude(mcu_temperature_degrees, (MATH_U8_SIZE_BITS - 1), &mcu_temperature_degrees_signed_magnitude);
+        math_status = MATH_integer_to_signed_magnitude(analog_snapshot.data[ANALOG_CHANNEL_MCU_TEMPERATURE_DEGREES], (MATH_U8_SIZE_BITS - 1), &mcu_temperature_degrees_signed_magnitude);
         MATH_exit_error(SIGFOX_ERROR_BASE_MATH);
         // Build monitoring frame.
-        sigfox_ul_payload_monitoring.output_voltage_mv = output_voltage_mv;
-        sigfox_ul_payload_monitoring.output_current_ua = output_current_ua;
-        sigfox_ul_payload_monitoring.output_current_range = output_current_range;
-        sigfox_ul_payload_monitoring.mcu_voltage_mv = mcu_voltage_mv;
+        sigfox_ul_payload_monitoring.output_voltage_mv = analog_snapshot.data[ANALOG_CHANNEL_OUTPUT_VOLTAGE_MV];
+        sigfox_ul_payload_monitoring.output_current_ua = analog_snapshot.data[ANALOG_CHANNEL_OUTPUT_CURRENT_UA];
+        sigfox_ul_payload_monitoring.output_current_range = analog_snapshot.output_current_range;
+        sigfox_ul_payload_monitoring.mcu_voltage_mv = analog_snapshot.data[ANALOG_CHANNEL_MCU_VOLTAGE_MV];
         sigfox_ul_payload_monitoring.mcu_temperature_degrees = mcu_temperature_degrees_signed_magnitude;
+        sigfox_ul_payload_monitoring.mains_ripple_100hz_mv = mains_ripple_mv[0];
+        sigfox_ul_payload_monitoring.mains_ripple_120hz_mv = mains_ripple_mv[1];
         // Send monitoring data.
         td1208_status = TD1208_send_frame(sigfox_ul_payload_monitoring.frame, SIGFOX_UL_PAYLOAD_SIZE_MONITORING);
         TD1208_exit_error(SIGFOX_ERROR_BASE_TD1208);
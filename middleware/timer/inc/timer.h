@@ -0,0 +1,138 @@
+/*
+ * timer.h
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef __TIMER_H__
+#define __TIMER_H__
+
+#include "error.h"
+#include "event.h"
+#include "tim.h"
+#include "types.h"
+
+/*** TIMER structures ***/
+
+/*!******************************************************************
+ * \enum TIMER_status_t
+ * \brief TIMER driver error codes.
+ *******************************************************************/
+typedef enum {
+    // Driver errors.
+    TIMER_SUCCESS = 0,
+    TIMER_ERROR_NULL_PARAMETER,
+    TIMER_ERROR_PERIOD,
+    TIMER_ERROR_MODE,
+    TIMER_ERROR_DISPATCH,
+    // Low level drivers errors.
+    TIMER_ERROR_BASE_TIM = ERROR_BASE_STEP,
+    TIMER_ERROR_BASE_EVENT = (TIMER_ERROR_BASE_TIM + TIM_ERROR_BASE_LAST),
+    // Last base value.
+    TIMER_ERROR_BASE_LAST = (TIMER_ERROR_BASE_EVENT + EVENT_ERROR_BASE_LAST)
+} TIMER_status_t;
+
+/*!******************************************************************
+ * \enum TIMER_mode_t
+ * \brief Software timer modes.
+ *******************************************************************/
+typedef enum {
+    TIMER_MODE_ONE_SHOT = 0,
+    TIMER_MODE_PERIODIC,
+    TIMER_MODE_LAST
+} TIMER_mode_t;
+
+/*!******************************************************************
+ * \enum TIMER_dispatch_t
+ * \brief Software timer callback execution context.
+ *******************************************************************/
+typedef enum {
+    TIMER_DISPATCH_IRQ = 0,
+    TIMER_DISPATCH_TASK,
+    TIMER_DISPATCH_LAST
+} TIMER_dispatch_t;
+
+/*!******************************************************************
+ * \fn TIMER_callback_t
+ * \brief Software timer expiration callback.
+ *******************************************************************/
+typedef void (*TIMER_callback_t)(void);
+
+/*!******************************************************************
+ * \struct TIMER_t
+ * \brief Software timer (statically allocated by the caller, fields are private).
+ *******************************************************************/
+typedef struct TIMER_struct {
+    struct TIMER_struct* next;
+    struct TIMER_struct** link;
+    struct TIMER_struct* pending_next;
+    uint32_t expiration_ms;
+    uint32_t period_ms;
+    TIMER_mode_t mode;
+    TIMER_dispatch_t dispatch;
+    TIMER_callback_t callback;
+    uint8_t pending;
+} TIMER_t;
+
+/*** TIMER functions ***/
+
+/*!******************************************************************
+ * \fn TIMER_status_t TIMER_init(void)
+ * \brief Init timer service and start the hardware timer (tickless, woken up on the next wheel event only).
+ * \param[in]   none
+ * \param[out]  none
+ * \retval      Function execution status.
+ *******************************************************************/
+TIMER_status_t TIMER_init(void);
+
+/*!******************************************************************
+ * \fn TIMER_status_t TIMER_de_init(void)
+ * \brief Release timer service.
+ * \param[in]   none
+ * \param[out]  none
+ * \retval      Function execution status.
+ *******************************************************************/
+TIMER_status_t TIMER_de_init(void);
+
+/*!******************************************************************
+ * \fn TIMER_status_t TIMER_start(TIMER_t* timer, uint32_t period_ms, TIMER_mode_t mode, TIMER_dispatch_t dispatch, TIMER_callback_t callback)
+ * \brief Start a software timer (restart it if already running).
+ * \param[in]   timer: Timer to start.
+ * \param[in]   period_ms: Delay before expiration (and reload value in periodic mode) in ms.
+ * \param[in]   mode: Timer mode.
+ * \param[in]   dispatch: Callback execution context (interrupt or main loop).
+ * \param[in]   callback: Function called on expiration.
+ * \param[out]  none
+ * \retval      Function execution status.
+ *******************************************************************/
+TIMER_status_t TIMER_start(TIMER_t* timer, uint32_t period_ms, TIMER_mode_t mode, TIMER_dispatch_t dispatch, TIMER_callback_t callback);
+
+/*!******************************************************************
+ * \fn TIMER_status_t TIMER_stop(TIMER_t* timer)
+ * \brief Stop a software timer and discard its pending callback.
+ * \param[in]   timer: Timer to stop.
+ * \param[out]  none
+ * \retval      Function execution status.
+ *******************************************************************/
+TIMER_status_t TIMER_stop(TIMER_t* timer);
+
+/*!******************************************************************
+ * \fn uint64_t TIMER_get_time_us(void)
+ * \brief Get the monotonic system time (interrupt safe).
+ * \param[in]   none
+ * \param[out]  none
+ * \retval      Time since timer service init in us.
+ *******************************************************************/
+uint64_t TIMER_get_time_us(void);
+
+/*******************************************************************/
+#define TIMER_exit_error(base) { ERROR_check_exit(timer_status, TIMER_SUCCESS, base) }
+
+/*******************************************************************/
+#define TIMER_stack_error(base) { ERROR_check_stack(timer_status, TIMER_SUCCESS, base) }
+
+/*******************************************************************/
+#define TIMER_stack_exit_error(base, code) { ERROR_check_stack_exit(timer_status, TIMER_SUCCESS, base, code) }
+
+#endif /* __TIMER_H__ */
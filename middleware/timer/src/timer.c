@@ -0,0 +1,439 @@
+/*
+ * timer.c
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "timer.h"
+
+#include "error.h"
+#include "error_base.h"
+#include "event.h"
+#include "mcu_mapping.h"
+#include "nvic_priority.h"
+#include "tim.h"
+#include "tim_registers.h"
+#include "types.h"
+
+/*** TIMER local macros ***/
+
+// Must match TIM_INSTANCE_TIMER.
+#define TIMER_TICK_REGISTERS        TIM2
+#define TIMER_TICK_CR1_URS          (0b1 << 2)
+#define TIMER_TICK_CR1_ARPE         (0b1 << 7)
+#define TIMER_TICK_SR_UIF           (0b1 << 0)
+#define TIMER_TICK_EGR_UG           (0b1 << 0)
+
+// Hardware timer is started with a 1ms period, then reprogrammed to count microseconds.
+#define TIMER_TICK_INIT_PERIOD_MS   1
+#define TIMER_US_PER_MS             1000
+// Tickless mode: the hardware period is stretched up to the next wheel event (16-bits counter limit).
+#define TIMER_TICK_PERIOD_MS_MAX    64
+// Minimum distance between the counter and a new reload value (covers the register access time).
+#define TIMER_TICK_RELOAD_MARGIN_US 20
+
+// Each level covers 16 times the range of the previous one (16ms, 256ms, 4.1s, 65.5s).
+#define TIMER_WHEEL_LEVEL_BITS      4
+#define TIMER_WHEEL_NUMBER_OF_SLOTS (1 << TIMER_WHEEL_LEVEL_BITS)
+#define TIMER_WHEEL_SLOT_MASK       (TIMER_WHEEL_NUMBER_OF_SLOTS - 1)
+#define TIMER_WHEEL_NUMBER_OF_LEVELS 4
+// Longer delays are parked in the last level and re-inserted on each cascade.
+#define TIMER_WHEEL_DELAY_MS_MAX    ((1UL << (TIMER_WHEEL_LEVEL_BITS * TIMER_WHEEL_NUMBER_OF_LEVELS)) - 1)
+
+#define TIMER_PERIOD_MS_MAX         0x7FFFFFFF
+
+/*** TIMER local structures ***/
+
+/*******************************************************************/
+typedef struct {
+    volatile uint64_t time_us;
+    volatile uint32_t time_ms;
+    // Current hardware period and elapsed milliseconds not applied to the wheel yet.
+    volatile uint32_t period_ms;
+    volatile uint32_t catch_up_ms;
+    TIMER_t* wheel[TIMER_WHEEL_NUMBER_OF_LEVELS][TIMER_WHEEL_NUMBER_OF_SLOTS];
+    TIMER_t* pending_list;
+} TIMER_context_t;
+
+/*** TIMER local global variables ***/
+
+static TIMER_context_t timer_ctx;
+
+/*** TIMER local functions ***/
+
+/*******************************************************************/
+static uint32_t _TIMER_enter_critical(void) {
+    // Local variables.
+    uint32_t primask = 0;
+    // Save interrupt state and mask interrupts.
+    __asm volatile ("mrs %0, primask" : "=r" (primask));
+    __asm volatile ("cpsid i" : : : "memory");
+    return primask;
+}
+
+/*******************************************************************/
+static void _TIMER_exit_critical(uint32_t primask) {
+    // Restore interrupt state.
+    __asm volatile ("msr primask, %0" : : "r" (primask) : "memory");
+}
+
+/*******************************************************************/
+static void _TIMER_insert(TIMER_t* timer) {
+    // Local variables.
+    uint32_t delay_ms = ((timer->expiration_ms) - timer_ctx.time_ms);
+    uint32_t key = (timer->expiration_ms);
+    uint8_t level = 0;
+    TIMER_t** slot = NULL;
+    // Park long delays in the last level.
+    if (delay_ms > TIMER_WHEEL_DELAY_MS_MAX) {
+        delay_ms = TIMER_WHEEL_DELAY_MS_MAX;
+        key = (timer_ctx.time_ms + TIMER_WHEEL_DELAY_MS_MAX);
+    }
+    // Select level.
+    while ((delay_ms >> (TIMER_WHEEL_LEVEL_BITS * (level + 1))) != 0) {
+        level++;
+    }
+    slot = &(timer_ctx.wheel[level][(key >> (TIMER_WHEEL_LEVEL_BITS * level)) & TIMER_WHEEL_SLOT_MASK]);
+    // Push timer in slot list.
+    timer->next = (*slot);
+    if ((*slot) != NULL) {
+        (*slot)->link = &(timer->next);
+    }
+    timer->link = slot;
+    (*slot) = timer;
+}
+
+/*******************************************************************/
+static void _TIMER_remove(TIMER_t* timer) {
+    // Check if timer is in the wheel.
+    if ((timer->link) == NULL) return;
+    // Unlink timer.
+    (*(timer->link)) = (timer->next);
+    if ((timer->next) != NULL) {
+        timer->next->link = (timer->link);
+    }
+    timer->next = NULL;
+    timer->link = NULL;
+}
+
+/*******************************************************************/
+static void _TIMER_remove_pending(TIMER_t* timer) {
+    // Local variables.
+    TIMER_t** link = &(timer_ctx.pending_list);
+    // Check flag.
+    if ((timer->pending) == 0) return;
+    // Search timer in pending list.
+    while ((*link) != NULL) {
+        if ((*link) == timer) {
+            (*link) = (timer->pending_next);
+            break;
+        }
+        link = &((*link)->pending_next);
+    }
+    timer->pending_next = NULL;
+    timer->pending = 0;
+}
+
+/*******************************************************************/
+static void _TIMER_cascade(uint8_t level, uint8_t slot_index) {
+    // Local variables.
+    TIMER_t* timer = timer_ctx.wheel[level][slot_index];
+    TIMER_t* next = NULL;
+    // Detach slot list.
+    timer_ctx.wheel[level][slot_index] = NULL;
+    // Re-insert timers in lower levels.
+    while (timer != NULL) {
+        next = (timer->next);
+        timer->next = NULL;
+        timer->link = NULL;
+        _TIMER_insert(timer);
+        timer = next;
+    }
+}
+
+/*******************************************************************/
+static uint32_t _TIMER_get_next_period_ms(void) {
+    // Local variables.
+    uint32_t period_ms = 0;
+    uint32_t time_ms = 0;
+    uint8_t level = 0;
+    uint8_t wheel_event = 0;
+    // Search next non empty slot or cascade.
+    for (period_ms = 1; period_ms < TIMER_TICK_PERIOD_MS_MAX; period_ms++) {
+        time_ms = (timer_ctx.time_ms + period_ms);
+        if (timer_ctx.wheel[0][time_ms & TIMER_WHEEL_SLOT_MASK] != NULL) break;
+        for (level = 1; level < TIMER_WHEEL_NUMBER_OF_LEVELS; level++) {
+            if ((time_ms & ((1UL << (TIMER_WHEEL_LEVEL_BITS * level)) - 1)) != 0) break;
+            if (timer_ctx.wheel[level][(time_ms >> (TIMER_WHEEL_LEVEL_BITS * level)) & TIMER_WHEEL_SLOT_MASK] != NULL) {
+                wheel_event = 1;
+                break;
+            }
+        }
+        if (wheel_event != 0) break;
+    }
+    return period_ms;
+}
+
+/*******************************************************************/
+static void _TIMER_set_period(uint32_t period_ms) {
+    // Postpone by one millisecond if the counter is about to pass the new reload value.
+    while (((period_ms * TIMER_US_PER_MS) - 1) <= ((TIMER_TICK_REGISTERS->CNT) + TIMER_TICK_RELOAD_MARGIN_US)) {
+        period_ms++;
+    }
+    TIMER_TICK_REGISTERS->ARR = ((period_ms * TIMER_US_PER_MS) - 1);
+    timer_ctx.period_ms = period_ms;
+}
+
+/*******************************************************************/
+static uint32_t _TIMER_get_elapsed_ms(void) {
+    // Local variables.
+    uint32_t elapsed_ms = timer_ctx.catch_up_ms;
+    // Add current hardware period (counter restarted from 0 if an update is pending).
+    if (((TIMER_TICK_REGISTERS->SR) & TIMER_TICK_SR_UIF) != 0) {
+        elapsed_ms += timer_ctx.period_ms;
+    }
+    elapsed_ms += ((TIMER_TICK_REGISTERS->CNT) / TIMER_US_PER_MS);
+    return elapsed_ms;
+}
+
+/*******************************************************************/
+static void _TIMER_tick_irq_callback(void) {
+    // Local variables.
+    TIMER_t** slot = NULL;
+    TIMER_t* timer = NULL;
+    TIMER_callback_t callback = NULL;
+    uint32_t time_ms = 0;
+    uint32_t primask = 0;
+    uint8_t post_event = 0;
+    uint8_t level = 0;
+    // Update time with the whole hardware period (flag cleared here since elapsed time computations rely on it).
+    primask = _TIMER_enter_critical();
+    TIMER_TICK_REGISTERS->SR = ~TIMER_TICK_SR_UIF;
+    timer_ctx.time_us += (((uint64_t) timer_ctx.period_ms) * TIMER_US_PER_MS);
+    timer_ctx.catch_up_ms = timer_ctx.period_ms;
+    _TIMER_exit_critical(primask);
+    // Step the wheel through each elapsed millisecond.
+    while (1) {
+        primask = _TIMER_enter_critical();
+        if (timer_ctx.catch_up_ms == 0) {
+            // Program next hardware period (unless another update is already pending).
+            if (((TIMER_TICK_REGISTERS->SR) & TIMER_TICK_SR_UIF) == 0) {
+                _TIMER_set_period(_TIMER_get_next_period_ms());
+            }
+            _TIMER_exit_critical(primask);
+            break;
+        }
+        timer_ctx.catch_up_ms--;
+        timer_ctx.time_ms++;
+        time_ms = timer_ctx.time_ms;
+        // Cascade upper levels when lower ones wrap.
+        for (level = 1; level < TIMER_WHEEL_NUMBER_OF_LEVELS; level++) {
+            if ((time_ms & ((1UL << (TIMER_WHEEL_LEVEL_BITS * level)) - 1)) != 0) break;
+            _TIMER_cascade(level, ((time_ms >> (TIMER_WHEEL_LEVEL_BITS * level)) & TIMER_WHEEL_SLOT_MASK));
+        }
+        _TIMER_exit_critical(primask);
+        // Expire current slot one timer at a time, since callbacks may start or stop timers.
+        slot = &(timer_ctx.wheel[0][time_ms & TIMER_WHEEL_SLOT_MASK]);
+        while (1) {
+            primask = _TIMER_enter_critical();
+            timer = (*slot);
+            if (timer == NULL) {
+                _TIMER_exit_critical(primask);
+                break;
+            }
+            _TIMER_remove(timer);
+            // Reload periodic timer without drift.
+            if ((timer->mode) == TIMER_MODE_PERIODIC) {
+                timer->expiration_ms += (timer->period_ms);
+                _TIMER_insert(timer);
+            }
+            callback = (timer->callback);
+            // Defer task context callbacks to main loop.
+            if ((timer->dispatch) == TIMER_DISPATCH_TASK) {
+                if ((timer->pending) == 0) {
+                    timer->pending = 1;
+                    timer->pending_next = timer_ctx.pending_list;
+                    timer_ctx.pending_list = timer;
+                }
+                callback = NULL;
+                post_event = 1;
+            }
+            _TIMER_exit_critical(primask);
+            // Call interrupt context callback.
+            if (callback != NULL) {
+                callback();
+            }
+        }
+    }
+    if (post_event != 0) {
+        EVENT_post(EVENT_TIMER_PROCESS);
+    }
+}
+
+/*******************************************************************/
+static void _TIMER_process_event_handler(void) {
+    // Local variables.
+    TIMER_t* timer = NULL;
+    TIMER_callback_t callback = NULL;
+    uint32_t primask = 0;
+    // Pending timers loop.
+    while (1) {
+        primask = _TIMER_enter_critical();
+        timer = timer_ctx.pending_list;
+        if (timer == NULL) {
+            _TIMER_exit_critical(primask);
+            break;
+        }
+        timer_ctx.pending_list = (timer->pending_next);
+        timer->pending_next = NULL;
+        timer->pending = 0;
+        callback = (timer->callback);
+        _TIMER_exit_critical(primask);
+        // Call task context callback.
+        if (callback != NULL) {
+            callback();
+        }
+    }
+}
+
+/*** TIMER functions ***/
+
+/*******************************************************************/
+TIMER_status_t TIMER_init(void) {
+    // Local variables.
+    TIMER_status_t status = TIMER_SUCCESS;
+    TIM_status_t tim_status = TIM_SUCCESS;
+    EVENT_status_t event_status = EVENT_SUCCESS;
+    uint32_t primask = 0;
+    uint8_t level = 0;
+    uint8_t idx = 0;
+    // Init context.
+    timer_ctx.time_us = 0;
+    timer_ctx.time_ms = 0;
+    timer_ctx.period_ms = TIMER_TICK_INIT_PERIOD_MS;
+    timer_ctx.catch_up_ms = 0;
+    timer_ctx.pending_list = NULL;
+    for (level = 0; level < TIMER_WHEEL_NUMBER_OF_LEVELS; level++) {
+        for (idx = 0; idx < TIMER_WHEEL_NUMBER_OF_SLOTS; idx++) {
+            timer_ctx.wheel[level][idx] = NULL;
+        }
+    }
+    // Register task context dispatcher.
+    event_status = EVENT_register(EVENT_TIMER_PROCESS, &_TIMER_process_event_handler);
+    EVENT_exit_error(TIMER_ERROR_BASE_EVENT);
+    // Init and start hardware timer.
+    tim_status = TIM_STD_init(TIM_INSTANCE_TIMER, NVIC_PRIORITY_TIMER);
+    TIM_exit_error(TIMER_ERROR_BASE_TIM);
+    tim_status = TIM_STD_start(TIM_INSTANCE_TIMER, TIMER_TICK_INIT_PERIOD_MS, TIM_UNIT_MS, &_TIMER_tick_irq_callback);
+    TIM_exit_error(TIMER_ERROR_BASE_TIM);
+    // Switch to a 1MHz counter deduced from the 1ms period settings, with immediate reload updates.
+    primask = _TIMER_enter_critical();
+    TIMER_TICK_REGISTERS->PSC = (((((TIMER_TICK_REGISTERS->PSC) + 1) * ((TIMER_TICK_REGISTERS->ARR) + 1)) / (TIMER_TICK_INIT_PERIOD_MS * TIMER_US_PER_MS)) - 1);
+    TIMER_TICK_REGISTERS->CR1 &= ~TIMER_TICK_CR1_ARPE;
+    TIMER_TICK_REGISTERS->CR1 |= TIMER_TICK_CR1_URS;
+    TIMER_TICK_REGISTERS->ARR = ((TIMER_TICK_PERIOD_MS_MAX * TIMER_US_PER_MS) - 1);
+    // Reload prescaler and restart counter (without update interrupt thanks to URS).
+    TIMER_TICK_REGISTERS->EGR = TIMER_TICK_EGR_UG;
+    _TIMER_set_period(_TIMER_get_next_period_ms());
+    _TIMER_exit_critical(primask);
+errors:
+    return status;
+}
+
+/*******************************************************************/
+TIMER_status_t TIMER_de_init(void) {
+    // Local variables.
+    TIMER_status_t status = TIMER_SUCCESS;
+    TIM_status_t tim_status = TIM_SUCCESS;
+    // Stop hardware tick.
+    tim_status = TIM_STD_stop(TIM_INSTANCE_TIMER);
+    TIM_stack_error(ERROR_BASE_TIMER + TIMER_ERROR_BASE_TIM);
+    tim_status = TIM_STD_de_init(TIM_INSTANCE_TIMER);
+    TIM_stack_error(ERROR_BASE_TIMER + TIMER_ERROR_BASE_TIM);
+    return status;
+}
+
+/*******************************************************************/
+TIMER_status_t TIMER_start(TIMER_t* timer, uint32_t period_ms, TIMER_mode_t mode, TIMER_dispatch_t dispatch, TIMER_callback_t callback) {
+    // Local variables.
+    TIMER_status_t status = TIMER_SUCCESS;
+    uint32_t delay_ms = 0;
+    uint32_t primask = 0;
+    // Check parameters.
+    if ((timer == NULL) || (callback == NULL)) {
+        status = TIMER_ERROR_NULL_PARAMETER;
+        goto errors;
+    }
+    if ((period_ms == 0) || (period_ms > TIMER_PERIOD_MS_MAX)) {
+        status = TIMER_ERROR_PERIOD;
+        goto errors;
+    }
+    if (mode >= TIMER_MODE_LAST) {
+        status = TIMER_ERROR_MODE;
+        goto errors;
+    }
+    if (dispatch >= TIMER_DISPATCH_LAST) {
+        status = TIMER_ERROR_DISPATCH;
+        goto errors;
+    }
+    primask = _TIMER_enter_critical();
+    // Restart timer if needed.
+    _TIMER_remove(timer);
+    _TIMER_remove_pending(timer);
+    // Configure timer.
+    timer->period_ms = period_ms;
+    timer->mode = mode;
+    timer->dispatch = dispatch;
+    timer->callback = callback;
+    // Wheel time is only updated on hardware period end: add elapsed time of the current one.
+    delay_ms = (_TIMER_get_elapsed_ms() + period_ms);
+    timer->expiration_ms = (timer_ctx.time_ms + delay_ms);
+    _TIMER_insert(timer);
+    // Shorten current hardware period if needed (otherwise done at the end of the interrupt).
+    if ((timer_ctx.catch_up_ms == 0) && (((TIMER_TICK_REGISTERS->SR) & TIMER_TICK_SR_UIF) == 0) && (delay_ms < timer_ctx.period_ms)) {
+        _TIMER_set_period(delay_ms);
+    }
+    _TIMER_exit_critical(primask);
+errors:
+    return status;
+}
+
+/*******************************************************************/
+TIMER_status_t TIMER_stop(TIMER_t* timer) {
+    // Local variables.
+    TIMER_status_t status = TIMER_SUCCESS;
+    uint32_t primask = 0;
+    // Check parameter.
+    if (timer == NULL) {
+        status = TIMER_ERROR_NULL_PARAMETER;
+        goto errors;
+    }
+    primask = _TIMER_enter_critical();
+    _TIMER_remove(timer);
+    _TIMER_remove_pending(timer);
+    _TIMER_exit_critical(primask);
+errors:
+    return status;
+}
+
+/*******************************************************************/
+uint64_t TIMER_get_time_us(void) {
+    // Local variables.
+    uint64_t time_us = 0;
+    uint32_t counter = 0;
+    uint32_t primask = 0;
+    // Read tick count and hardware counter atomically.
+    primask = _TIMER_enter_critical();
+    time_us = timer_ctx.time_us;
+    counter = (TIMER_TICK_REGISTERS->CNT);
+    // Check if an update is pending but not yet served.
+    if (((TIMER_TICK_REGISTERS->SR) & TIMER_TICK_SR_UIF) != 0) {
+        counter = (TIMER_TICK_REGISTERS->CNT);
+        time_us += (((uint64_t) timer_ctx.period_ms) * TIMER_US_PER_MS);
+    }
+    _TIMER_exit_critical(primask);
+    // Counter runs at 1MHz.
+    time_us += counter;
+    return time_us;
+}
@@ -0,0 +1,237 @@
+/*
+ * analog_maths_test.c
+ *
+ *  Created on: 17 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "analog_maths.h"
+#include "types.h"
+// Host standard library (included after types.h which defines NULL).
+#include <stdio.h>
+
+/*** ANALOG MATHS TEST local macros ***/
+
+// Settings mirrored from analog.c.
+#define ANALOG_ADC_RESOLUTION_BITS              12
+#define ANALOG_ADC_FULL_SCALE                   ((0b1 << ANALOG_ADC_RESOLUTION_BITS) - 1)
+#define ANALOG_CALIBRATION_FRACTIONAL_BITS      8
+#define ANALOG_REF191_VOLTAGE_MV                2048
+#define ANALOG_OUTPUT_CURRENT_RATIO             4
+#define ANALOG_OUTPUT_CURRENT_RESOLUTION_BITS   13
+#define ANALOG_OUTPUT_VOLTAGE_RESOLUTION_BITS   15
+#define ANALOG_MCU_VOLTAGE_MV_MAX               0xFFFF
+#define ANALOG_TS_CAL1_TEMPERATURE_DEGREES      30
+#define ANALOG_TS_CAL2_TEMPERATURE_DEGREES      130
+#define ANALOG_TS_CAL_VDDA_MV                   3000
+
+// REF191 data range (the reference is below the supply voltage, which is at most 4.095V).
+#define ANALOG_MATHS_TEST_REF191_12BITS_MIN     2048
+#define ANALOG_MATHS_TEST_REF191_12BITS_MAX     ANALOG_ADC_FULL_SCALE
+// MCU supply voltage and temperature sensor factory calibration ranges.
+#define ANALOG_MATHS_TEST_MCU_VOLTAGE_MV_MIN    1650
+#define ANALOG_MATHS_TEST_MCU_VOLTAGE_MV_MAX    3600
+#define ANALOG_MATHS_TEST_TS_CAL1_MIN           600
+#define ANALOG_MATHS_TEST_TS_CAL1_MAX           750
+#define ANALOG_MATHS_TEST_TS_CAL1_STEP          25
+#define ANALOG_MATHS_TEST_TS_CAL_DELTA_MIN      150
+#define ANALOG_MATHS_TEST_TS_CAL_DELTA_MAX      350
+#define ANALOG_MATHS_TEST_TS_CAL_DELTA_STEP     50
+
+#define ANALOG_MATHS_TEST_SQRT_EXHAUSTIVE_MAX   (0b1 << 24)
+#define ANALOG_MATHS_TEST_SQRT_RANDOM_COUNT     1000000
+
+/*** ANALOG MATHS TEST local structures ***/
+
+/*******************************************************************/
+typedef struct {
+    const char_t* name;
+    uint64_t count;
+    uint32_t error_count;
+} ANALOG_MATHS_TEST_result_t;
+
+/*** ANALOG MATHS TEST local global variables ***/
+
+static const uint32_t ANALOG_MATHS_TEST_DIVIDER_RATIO[] = { 2, 6 };
+static const uint32_t ANALOG_MATHS_TEST_DIVIDER_RESISTANCE_OHMS[] = { 998000, 599000 };
+
+/*** ANALOG MATHS TEST local functions ***/
+
+/*******************************************************************/
+static void _ANALOG_MATHS_TEST_check(ANALOG_MATHS_TEST_result_t* result, int64_t value, int64_t expected, int64_t tolerance, uint32_t divisor, int64_t dividend) {
+    // Local variables.
+    int64_t error = (value - expected);
+    // Count checks.
+    result->count++;
+    if ((error > tolerance) || (error < (-tolerance))) {
+        // Print first errors only.
+        if (result->error_count < 8) {
+            printf("%s: %lld / %u = %lld (expected %lld)\n", result->name, (long long) dividend, divisor, (long long) value, (long long) expected);
+        }
+        result->error_count++;
+    }
+}
+
+/*******************************************************************/
+static void _ANALOG_MATHS_TEST_check_unsigned(ANALOG_MATHS_TEST_result_t* result, uint32_t divisor, uint32_t dividend, ANALOG_MATHS_reciprocal_t* reciprocal) {
+    // Compare reciprocal with C division.
+    _ANALOG_MATHS_TEST_check(result, (int64_t) ANALOG_MATHS_divide(dividend, reciprocal), (int64_t) (dividend / divisor), 0, divisor, (int64_t) dividend);
+}
+
+/*******************************************************************/
+static void _ANALOG_MATHS_TEST_output_voltage(ANALOG_MATHS_TEST_result_t* result) {
+    // Local variables.
+    ANALOG_MATHS_reciprocal_t reciprocal;
+    uint32_t divisor = 0;
+    uint32_t divisor_min = (ANALOG_MATHS_TEST_REF191_12BITS_MIN << (ANALOG_OUTPUT_VOLTAGE_RESOLUTION_BITS - ANALOG_ADC_RESOLUTION_BITS));
+    uint32_t divisor_max = (ANALOG_MATHS_TEST_REF191_12BITS_MAX << (ANALOG_OUTPUT_VOLTAGE_RESOLUTION_BITS - ANALOG_ADC_RESOLUTION_BITS));
+    uint32_t data_max = ((0b1 << ANALOG_OUTPUT_VOLTAGE_RESOLUTION_BITS) - 1);
+    uint32_t data = 0;
+    uint32_t dividend_max = 0;
+    uint32_t output_voltage_mv_max = 0;
+    uint32_t output_voltage_mv = 0;
+    uint8_t idx = 0;
+    for (idx = 0; idx < (sizeof(ANALOG_MATHS_TEST_DIVIDER_RATIO) / sizeof(uint32_t)); idx++) {
+        // Output voltage channel: (data * VREF * ratio) / REF191, for all references and data at oversampled resolution.
+        dividend_max = data_max * ANALOG_REF191_VOLTAGE_MV * ANALOG_MATHS_TEST_DIVIDER_RATIO[idx];
+        for (divisor = divisor_min; divisor <= divisor_max; divisor++) {
+            ANALOG_MATHS_compute_reciprocal(divisor, dividend_max, &reciprocal);
+            for (data = 0; data <= data_max; data++) {
+                _ANALOG_MATHS_TEST_check_unsigned(&(result[0]), divisor, (data * ANALOG_REF191_VOLTAGE_MV * ANALOG_MATHS_TEST_DIVIDER_RATIO[idx]), &reciprocal);
+            }
+        }
+        // Output voltage divider current: (voltage * 1000) / resistance, up to the maximum voltage (lowest reference).
+        output_voltage_mv_max = (dividend_max / divisor_min);
+        ANALOG_MATHS_compute_reciprocal(ANALOG_MATHS_TEST_DIVIDER_RESISTANCE_OHMS[idx], (output_voltage_mv_max * 1000), &reciprocal);
+        for (output_voltage_mv = 0; output_voltage_mv <= output_voltage_mv_max; output_voltage_mv++) {
+            _ANALOG_MATHS_TEST_check_unsigned(&(result[1]), ANALOG_MATHS_TEST_DIVIDER_RESISTANCE_OHMS[idx], (output_voltage_mv * 1000), &reciprocal);
+        }
+        // Output voltage aligned on output current: (sum * VREF * ratio) / (REF191 * samples), for all references and sums.
+        dividend_max = ANALOG_ADC_FULL_SCALE * ANALOG_OUTPUT_CURRENT_RATIO * ANALOG_REF191_VOLTAGE_MV * ANALOG_MATHS_TEST_DIVIDER_RATIO[idx];
+        for (divisor = (ANALOG_MATHS_TEST_REF191_12BITS_MIN * ANALOG_OUTPUT_CURRENT_RATIO); divisor <= (ANALOG_MATHS_TEST_REF191_12BITS_MAX * ANALOG_OUTPUT_CURRENT_RATIO); divisor++) {
+            ANALOG_MATHS_compute_reciprocal(divisor, dividend_max, &reciprocal);
+            for (data = 0; data <= (ANALOG_ADC_FULL_SCALE * ANALOG_OUTPUT_CURRENT_RATIO); data++) {
+                _ANALOG_MATHS_TEST_check_unsigned(&(result[2]), divisor, (data * ANALOG_REF191_VOLTAGE_MV * ANALOG_MATHS_TEST_DIVIDER_RATIO[idx]), &reciprocal);
+            }
+        }
+        // Output voltage thresholds: (voltage * REF191) / (VREF * ratio), for all references and voltages.
+        divisor = ANALOG_REF191_VOLTAGE_MV * ANALOG_MATHS_TEST_DIVIDER_RATIO[idx];
+        ANALOG_MATHS_compute_reciprocal(divisor, (ANALOG_MCU_VOLTAGE_MV_MAX * ANALOG_ADC_FULL_SCALE), &reciprocal);
+        for (data = ANALOG_MATHS_TEST_REF191_12BITS_MIN; data <= ANALOG_MATHS_TEST_REF191_12BITS_MAX; data++) {
+            for (output_voltage_mv = 0; output_voltage_mv <= ANALOG_MCU_VOLTAGE_MV_MAX; output_voltage_mv++) {
+                _ANALOG_MATHS_TEST_check_unsigned(&(result[3]), divisor, (output_voltage_mv * data), &reciprocal);
+            }
+        }
+    }
+}
+
+/*******************************************************************/
+static void _ANALOG_MATHS_TEST_output_current(ANALOG_MATHS_TEST_result_t* result) {
+    // Local variables.
+    ANALOG_MATHS_reciprocal_t reciprocal;
+    uint32_t divisor = 0;
+    uint32_t divisor_min = (ANALOG_MATHS_TEST_REF191_12BITS_MIN << (ANALOG_OUTPUT_CURRENT_RESOLUTION_BITS - ANALOG_ADC_RESOLUTION_BITS));
+    uint32_t divisor_max = (ANALOG_MATHS_TEST_REF191_12BITS_MAX << (ANALOG_OUTPUT_CURRENT_RESOLUTION_BITS - ANALOG_ADC_RESOLUTION_BITS));
+    uint32_t data_max = ((0b1 << ANALOG_OUTPUT_CURRENT_RESOLUTION_BITS) - 1);
+    uint32_t data = 0;
+    // Output current channel: (data * VREF) / REF191, for all references and data at oversampled resolution.
+    for (divisor = divisor_min; divisor <= divisor_max; divisor++) {
+        ANALOG_MATHS_compute_reciprocal(divisor, (data_max * ANALOG_REF191_VOLTAGE_MV), &reciprocal);
+        for (data = 0; data <= data_max; data++) {
+            _ANALOG_MATHS_TEST_check_unsigned(result, divisor, (data * ANALOG_REF191_VOLTAGE_MV), &reciprocal);
+        }
+    }
+}
+
+/*******************************************************************/
+static void _ANALOG_MATHS_TEST_mcu_temperature(ANALOG_MATHS_TEST_result_t* result) {
+    // Local variables.
+    ANALOG_MATHS_reciprocal_t reciprocal;
+    int32_t ts_cal1 = 0;
+    int32_t ts_cal2 = 0;
+    int32_t delta = 0;
+    int32_t divisor = 0;
+    int32_t mcu_voltage_mv = 0;
+    int32_t data = 0;
+    int32_t dividend = 0;
+    int32_t temperature_degrees = 0;
+    int32_t reference_degrees = 0;
+    // T = T1 + (data * VDD - CAL1 * VDDA) / ((VDDA / (T2 - T1)) * (CAL2 - CAL1)), for all supply voltages and data.
+    for (ts_cal1 = ANALOG_MATHS_TEST_TS_CAL1_MIN; ts_cal1 <= ANALOG_MATHS_TEST_TS_CAL1_MAX; ts_cal1 += ANALOG_MATHS_TEST_TS_CAL1_STEP) {
+        for (delta = ANALOG_MATHS_TEST_TS_CAL_DELTA_MIN; delta <= ANALOG_MATHS_TEST_TS_CAL_DELTA_MAX; delta += ANALOG_MATHS_TEST_TS_CAL_DELTA_STEP) {
+            ts_cal2 = (ts_cal1 + delta);
+            divisor = (ANALOG_TS_CAL_VDDA_MV / (ANALOG_TS_CAL2_TEMPERATURE_DEGREES - ANALOG_TS_CAL1_TEMPERATURE_DEGREES)) * (ts_cal2 - ts_cal1);
+            ANALOG_MATHS_compute_reciprocal((uint32_t) divisor, (ANALOG_MCU_VOLTAGE_MV_MAX << ANALOG_ADC_RESOLUTION_BITS), &reciprocal);
+            for (mcu_voltage_mv = ANALOG_MATHS_TEST_MCU_VOLTAGE_MV_MIN; mcu_voltage_mv <= ANALOG_MATHS_TEST_MCU_VOLTAGE_MV_MAX; mcu_voltage_mv++) {
+                for (data = 0; data <= ANALOG_ADC_FULL_SCALE; data++) {
+                    dividend = (data * mcu_voltage_mv) - (ts_cal1 * ANALOG_TS_CAL_VDDA_MV);
+                    temperature_degrees = ANALOG_MATHS_divide_signed(dividend, &reciprocal) + ANALOG_TS_CAL1_TEMPERATURE_DEGREES;
+                    // Same formula with C division: must be exact.
+                    _ANALOG_MATHS_TEST_check(&(result[0]), temperature_degrees, ((dividend / divisor) + ANALOG_TS_CAL1_TEMPERATURE_DEGREES), 0, (uint32_t) divisor, dividend);
+                    // Reference formula (data first scaled to the calibration voltage): one degree difference allowed.
+                    reference_degrees = (((data * mcu_voltage_mv) / ANALOG_TS_CAL_VDDA_MV) - ts_cal1);
+                    reference_degrees = ((reference_degrees * (ANALOG_TS_CAL2_TEMPERATURE_DEGREES - ANALOG_TS_CAL1_TEMPERATURE_DEGREES)) / (ts_cal2 - ts_cal1)) + ANALOG_TS_CAL1_TEMPERATURE_DEGREES;
+                    _ANALOG_MATHS_TEST_check(&(result[1]), temperature_degrees, reference_degrees, 1, (uint32_t) divisor, dividend);
+                }
+            }
+        }
+    }
+}
+
+/*******************************************************************/
+static void _ANALOG_MATHS_TEST_sqrt(ANALOG_MATHS_TEST_result_t* result) {
+    // Local variables.
+    uint64_t value = 0;
+    uint64_t seed = 0x5DEECE66DULL;
+    uint64_t root = 0;
+    uint32_t idx = 0;
+    uint8_t valid = 0;
+    // Exhaustive on small values then random 64-bits values.
+    for (idx = 0; idx < (ANALOG_MATHS_TEST_SQRT_EXHAUSTIVE_MAX + ANALOG_MATHS_TEST_SQRT_RANDOM_COUNT); idx++) {
+        if (idx < ANALOG_MATHS_TEST_SQRT_EXHAUSTIVE_MAX) {
+            value = (uint64_t) idx;
+        }
+        else {
+            seed ^= (seed << 13);
+            seed ^= (seed >> 7);
+            seed ^= (seed << 17);
+            value = (seed >> (idx & 0x3F));
+        }
+        root = (uint64_t) ANALOG_MATHS_sqrt(value);
+        // Check floor property: root^2 <= value < (root + 1)^2.
+        valid = (((root * root) <= value) && (((unsigned __int128) (root + 1)) * ((unsigned __int128) (root + 1)) > value)) ? 1 : 0;
+        _ANALOG_MATHS_TEST_check(result, valid, 1, 0, 0, (int64_t) value);
+    }
+}
+
+/*** ANALOG MATHS TEST functions ***/
+
+/*******************************************************************/
+int main(void) {
+    // Local variables.
+    ANALOG_MATHS_TEST_result_t results[] = {
+        { "output_voltage", 0, 0 },
+        { "output_voltage_divider_current", 0, 0 },
+        { "output_voltage_aligned", 0, 0 },
+        { "output_voltage_threshold", 0, 0 },
+        { "output_current", 0, 0 },
+        { "mcu_temperature", 0, 0 },
+        { "mcu_temperature_reference", 0, 0 },
+        { "sqrt", 0, 0 }
+    };
+    uint8_t idx = 0;
+    int status = 0;
+    // Run all checks.
+    _ANALOG_MATHS_TEST_output_voltage(&(results[0]));
+    _ANALOG_MATHS_TEST_output_current(&(results[4]));
+    _ANALOG_MATHS_TEST_mcu_temperature(&(results[5]));
+    _ANALOG_MATHS_TEST_sqrt(&(results[7]));
+    // Print report.
+    for (idx = 0; idx < (sizeof(results) / sizeof(ANALOG_MATHS_TEST_result_t)); idx++) {
+        printf("%-32s %12llu checks %8u errors\n", results[idx].name, (unsigned long long) results[idx].count, results[idx].error_count);
+        if (results[idx].error_count != 0) {
+            status = 1;
+        }
+    }
+    return status;
+}